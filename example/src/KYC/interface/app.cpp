@@ -48,6 +48,8 @@
 #include "binINC/img_manifest.hpp"
 
 #include "cvision/time.hpp"
+#include "cvision/loader.hpp"
+#include "cvision/assetpack.hpp"
 
 #include "EZC/toolkit/filesystem.hpp"
 
@@ -75,14 +77,32 @@ uint8_t KYCApp::loadPackages()
 
     bool imgLoad = false, txtLoad = false;
 
-    for(const auto& ID : IMG_IDS)  // Load from binaries
+    cvis::CVAssetLoader& loader = assetLoader();
+
+    std::shared_ptr<cvis::CVAssetPack> pack = std::make_shared<cvis::CVAssetPack>();
+
+    if(pack->open("media/SYS/assets.cvpk"))  // Pre-decoded binaries, built by kyc_pack
     {
-        if(bitmaps.addTexture(IMG_ID_REG.at(ID), IMG_SIZE_REG.at(ID), ID)) imgLoad = true;
+        imgLoad = bitmaps.addPack(*pack) > 0;
+        txtLoad = fonts.addPack(pack) > 0;
     }
-
-    for(const auto& ID : FONT_IDS)
+    else
     {
-        if(fonts.addFont(FONT_ID_REG.at(ID), FONT_SIZE_REG.at(ID), ID)) txtLoad = true;
+        for(const auto& ID : IMG_IDS)  // Load from binaries
+        {
+            loader.queue(cvis::CVAssetLoader::ASSET_TEXTURE, IMG_ID_REG.at(ID), IMG_SIZE_REG.at(ID), ID);
+        }
+
+        bitmaps.setAtlasMode(true);     // Pack the embedded icons into shared pages
+        if(loader.load()) imgLoad = true;
+        bitmaps.setAtlasMode(false);
+
+        for(const auto& ID : FONT_IDS)
+        {
+            loader.queue(cvis::CVAssetLoader::ASSET_FONT, FONT_ID_REG.at(ID), FONT_SIZE_REG.at(ID), ID);
+        }
+
+        if(loader.load()) txtLoad = true;
     }
 
     PathList files;
@@ -104,14 +124,16 @@ uint8_t KYCApp::loadPackages()
     {
         if(cmpStringToList(path.extension().string(), { ".ttf" }))
         {
-            fonts.addFont(path.string(), path.stem().string());
+            loader.queue(cvis::CVAssetLoader::ASSET_FONT, path.string(), path.stem().string());
         }
         else if(cmpStringToList(path.extension().string(), { ".png", ".jpg", ".jpeg", ".bmp" }))
         {
-            bitmaps.addTexture(path.string(), path.stem().string());
+            loader.queue(cvis::CVAssetLoader::ASSET_TEXTURE, path.string(), path.stem().string());
         }
     }
 
+    loader.load();
+
     if(txtLoad & imgLoad) return IMPORT_SUCCESS;
     else if(txtLoad) return IMPORT_FONT_SUCCESS;
     else if(imgLoad) return IMPORT_IMAGE_SUCCESS;
@@ -0,0 +1,97 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely 
+// permissible under any circumstances.  Attribution to the 
+// Author ("Damian Tran") is appreciated but not necessary.
+// 
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+/** ========================================================================
+
+    KYC asset packer
+
+    Builds the asset pack that KYCApp maps at startup from the embedded
+    image and font binaries.  Icons are packed into shared atlas pages and
+    every page is stored pre-decoded with its mip levels, so the app can
+    upload them without decoding any PNG.
+
+    Usage: kyc_pack [output file]
+
+// ===================================================================== **/
+
+#include <iostream>
+#include <string>
+
+#include "binINC/font_manifest.hpp"
+#include "binINC/img_manifest.hpp"
+
+#include "cvision/assetpack.hpp"
+
+#define KYC_PACK_DEFAULT_PATH       "media/SYS/assets.cvpk"
+
+int main(int argc, char** argv)
+{
+
+    const std::string output = argc > 1 ? argv[1] : KYC_PACK_DEFAULT_PATH;
+
+    cvis::CVAssetPackWriter writer;
+    writer.setAtlasMode(true);
+    writer.setMipmaps(true);
+
+    for(const auto& ID : IMG_IDS)
+    {
+        if(!writer.addImage(IMG_ID_REG.at(ID), IMG_SIZE_REG.at(ID), ID)) return 1;
+    }
+
+    for(const auto& ID : FONT_IDS)
+    {
+        if(!writer.addFont(FONT_ID_REG.at(ID), FONT_SIZE_REG.at(ID), ID)) return 1;
+    }
+
+    if(!writer.write(output))
+    {
+        std::cout << "Failed to write asset pack: " << output << '\n';
+        return 1;
+    }
+
+    std::cout << "Packed " << IMG_IDS.size() << " images and "
+              << FONT_IDS.size() << " fonts into " << output << '\n';
+
+    return 0;
+
+}
@@ -0,0 +1,247 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely 
+// permissible under any circumstances.  Attribution to the 
+// Author ("Damian Tran") is appreciated but not necessary.
+// 
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+/** ========================================================================
+
+    Flood fill check
+
+    Compares imageops::floodFill against a plain breadth-first fill on
+    random images, tolerances, seeds and connectivities, then times a fill
+    over an 8192 x 8192 image.  Returns nonzero on the first mismatch.
+
+// ===================================================================== **/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cvision/imageops.hpp"
+
+using namespace cvis;
+
+namespace
+{
+
+const unsigned int checkRuns = 3000;
+const unsigned int timingExtent = 8192;
+
+struct ReferenceFill
+{
+    std::vector<uint8_t>    pixels;
+    sf::IntRect             bounds;
+};
+
+// Breadth-first fill, one pixel at a time
+
+ReferenceFill referenceFill(const std::vector<uint8_t>& source,
+                            const unsigned int& width,
+                            const unsigned int& height,
+                            const sf::Vector2i& seed,
+                            const sf::Color& color,
+                            const unsigned int& tolerance,
+                            const bool& diagonal)
+{
+    ReferenceFill output;
+    output.pixels = source;
+
+    const uint8_t* seedPixel = &source[(seed.y*width + seed.x)*4];
+    const uint8_t fill[4] = { color.r, color.g, color.b, color.a };
+
+    auto matches = [&](const int& x, const int& y)
+    {
+        const uint8_t* pixel = &source[(y*width + x)*4];
+        for(size_t k = 0; k < 4; ++k)
+        {
+            if(std::abs(int(pixel[k]) - int(seedPixel[k])) > int(tolerance)) return false;
+        }
+        return true;
+    };
+
+    std::vector<uint8_t> visited(size_t(width)*height, 0);
+    std::deque<std::pair<int, int>> queue;
+    queue.emplace_back(seed.x, seed.y);
+    visited[seed.y*width + seed.x] = 1;
+
+    int left = width, top = height, right = 0, bottom = 0;
+
+    while(!queue.empty())
+    {
+        const int x = queue.front().first;
+        const int y = queue.front().second;
+        queue.pop_front();
+
+        memcpy(&output.pixels[(y*width + x)*4], fill, 4);
+        left = std::min(left, x);
+        top = std::min(top, y);
+        right = std::max(right, x + 1);
+        bottom = std::max(bottom, y + 1);
+
+        for(int dy = -1; dy <= 1; ++dy)
+        {
+            for(int dx = -1; dx <= 1; ++dx)
+            {
+                if((!dx && !dy) || (!diagonal && dx && dy)) continue;
+
+                const int nx = x + dx, ny = y + dy;
+                if((nx < 0) || (ny < 0) || (nx >= int(width)) || (ny >= int(height))) continue;
+                if(visited[ny*width + nx] || !matches(nx, ny)) continue;
+
+                visited[ny*width + nx] = 1;
+                queue.emplace_back(nx, ny);
+            }
+        }
+    }
+
+    output.bounds = sf::IntRect(left, top, right - left, bottom - top);
+    return output;
+}
+
+bool checkEquivalence()
+{
+    std::mt19937 rng(7);
+
+    for(unsigned int run = 0; run < checkRuns; ++run)
+    {
+        const unsigned int width = 1 + rng() % 120;
+        const unsigned int height = 1 + rng() % 90;
+        const unsigned int colorCount = 1 + rng() % 4;
+
+        // A small palette, sometimes with two near colours to exercise tolerance
+
+        uint8_t palette[4][4];
+        for(auto& entry : palette)
+        {
+            for(auto& channel : entry) channel = rng();
+        }
+        if(rng() % 2)
+        {
+            for(size_t k = 0; k < 4; ++k) palette[1][k] = palette[0][k] + rng() % 8;
+        }
+
+        std::vector<uint8_t> source(size_t(width)*height*4);
+        for(size_t i = 0; i < size_t(width)*height; ++i)
+        {
+            const unsigned int index = (rng() % 10 < 7) ? 0 : rng() % colorCount;
+            memcpy(&source[i*4], palette[index], 4);
+        }
+
+        const unsigned int tolerance = (rng() % 3 == 0) ? 0 : rng() % 40;
+        const bool diagonal = rng() % 2;
+        const sf::Vector2i seed(rng() % width, rng() % height);
+
+        const uint8_t* seedPixel = &source[(seed.y*width + seed.x)*4];
+        sf::Color color;
+        if(rng() % 4 == 0) color = sf::Color(seedPixel[0], seedPixel[1], seedPixel[2], seedPixel[3]);
+        else color = sf::Color(rng(), rng(), rng(), rng());
+
+        std::vector<uint8_t> result = source;
+        const sf::IntRect bounds = floodFill(CVImageSpan(result, width, height), seed, color, tolerance, diagonal);
+
+        // Filling with the seed's own colour at zero tolerance leaves the image alone
+
+        if(!tolerance && (color == sf::Color(seedPixel[0], seedPixel[1], seedPixel[2], seedPixel[3])))
+        {
+            if((result != source) || bounds.width || bounds.height)
+            {
+                printf("Run %u: filling with the seed colour changed the image\n", run);
+                return false;
+            }
+            continue;
+        }
+
+        const ReferenceFill expected = referenceFill(source, width, height, seed, color, tolerance, diagonal);
+
+        if(result != expected.pixels)
+        {
+            printf("Run %u: pixels differ (%u x %u, tolerance %u, diagonal %d)\n",
+                   run, width, height, tolerance, int(diagonal));
+            return false;
+        }
+        if(bounds != expected.bounds)
+        {
+            printf("Run %u: bounds differ (%d, %d, %d, %d) vs (%d, %d, %d, %d)\n", run,
+                   bounds.left, bounds.top, bounds.width, bounds.height,
+                   expected.bounds.left, expected.bounds.top, expected.bounds.width, expected.bounds.height);
+            return false;
+        }
+    }
+
+    printf("Flood fill matches the reference over %u runs\n", checkRuns);
+    return true;
+}
+
+void timeLargeFill()
+{
+    // Walls every 64 rows with a gap every 1024 pixels, so the fill winds through the image
+
+    std::vector<uint8_t> pixels(size_t(timingExtent)*timingExtent*4, 200);
+    for(unsigned int y = 0; y < timingExtent; y += 64)
+    {
+        for(unsigned int x = 0; x < timingExtent; ++x)
+        {
+            if(x % 1024) pixels[(size_t(y)*timingExtent + x)*4] = 0;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const sf::IntRect bounds = floodFill(CVImageSpan(pixels, timingExtent, timingExtent),
+                                         sf::Vector2i(5, 5), sf::Color(1, 2, 3, 255), 10);
+    const auto end = std::chrono::steady_clock::now();
+
+    printf("%u x %u fill: %.1f ms, bounds %d x %d\n", timingExtent, timingExtent,
+           std::chrono::duration<double, std::milli>(end - start).count(), bounds.width, bounds.height);
+}
+
+}
+
+int main()
+{
+    if(!checkEquivalence()) return 1;
+    timeLargeFill();
+    return 0;
+}
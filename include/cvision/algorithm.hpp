@@ -76,6 +76,7 @@ namespace cvis
 {
 
 class CVElement;
+class CVThreadPool;
 
 template<typename T1, typename T2> constexpr bool operator==(const sf::Vector2<T1>& LHS, const sf::Vector2<T2>& RHS)
 {
@@ -545,7 +546,8 @@ CVISION_API void modulate(sf::Image& image, const sf::Color& newColor);
 CVISION_API void expand_canvas(sf::Image& image,
                                const sf::Vector2i& distance,
                                const sf::Color& background = sf::Color::Transparent);
-CVISION_API void gaussianBlur(sf::Image& image, const int& radius = 6);
+CVISION_API void gaussianBlur(sf::Image& image, const int& radius = 6,
+                              CVThreadPool* pool = nullptr);  // Radius is the standard deviation in pixels
 
 }
 
@@ -65,6 +65,8 @@ namespace cvis
 {
 
 class CVView;
+class CVThreadPool;
+class CVAssetLoader;
 
 class CVISION_API CVApp
 {
@@ -82,6 +84,11 @@ protected:
 
     sf::Context appGLContext;
 
+    CVThreadPool* taskPool;
+    std::mutex taskPoolLock;
+
+    CVAssetLoader* assetLoad;
+
     std::vector<std::string> unhandledEvents;
 
     std::chrono::duration<float> updateLatency;
@@ -143,6 +150,9 @@ public:
 
     CVISION_API const sf::Font* getTypeFont(const std::string& type) const;
 
+    CVISION_API CVThreadPool& threadPool(); // Work-stealing pool shared by all views, created on first use
+    CVISION_API CVAssetLoader& assetLoader(); // Parallel image and font decoding for loadPackages(), created on first use
+
     // App virtuals
 
     virtual uint8_t loadPackages() = 0; // Load data and media required for this app to run
@@ -186,6 +196,17 @@ public:
 
     CVISION_API void mainUpdate();
 
+    /** @brief Run every pending view on the calling thread until all have closed
+      *
+      * Replaces the thread-per-view model: views in viewList which have
+      * not been started are opened here and serviced by frame deadline,
+      * each at its own frame rate limit, with a single GL context switch
+      * per view per frame.  Views added while the scheduler runs are
+      * picked up on the next pass.  Do not call init() on scheduled views.
+      */
+    CVISION_API void runViewScheduler();
+    CVISION_API std::thread* launchViewScheduler();   // Run the scheduler on a new thread (appended to viewThreads)
+
     CVISION_API CVApp(unsigned int frameRate = 60,
            float leftClickLatency = 0.5,
            float rightClickLatency = 0.5,
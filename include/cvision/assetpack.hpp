@@ -0,0 +1,228 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_ASSETPACK
+#define CVIS_ASSETPACK
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <SFML/Graphics.hpp>
+
+#include "cvision/import.hpp"
+
+#define CV_PACK_VERSION                 1
+
+#define CV_PACK_PAGE_STANDALONE         0x01    // Page holds a single image at its origin
+
+namespace cvis
+{
+
+/** ========================================================================
+
+    Asset pack file layout (native byte order, version CV_PACK_VERSION)
+
+    CVPackHeader
+    CVPackPage      [numPages]
+    CVPackImage     [numImages]
+    CVPackFont      [numFonts]
+    Tag strings     [stringSize]
+    Data            Page mip levels as tightly packed RGBA, largest first,
+                    and font files verbatim.  Each block is 16 byte aligned.
+
+// ===================================================================== **/
+
+struct CVPackHeader
+{
+    char            magic[4];       // "CVPK"
+    uint32_t        version;
+    uint32_t        numPages;
+    uint32_t        numImages;
+    uint32_t        numFonts;
+    uint32_t        stringSize;
+};
+
+struct CVPackPage
+{
+    uint32_t        width;
+    uint32_t        height;
+    uint32_t        levels;         // 1: no mipmaps
+    uint32_t        flags;
+    uint64_t        offset;
+};
+
+struct CVPackImage
+{
+    uint32_t        tagOffset;
+    uint32_t        tagSize;
+    uint32_t        page;
+    int32_t         left;
+    int32_t         top;
+    int32_t         width;
+    int32_t         height;
+    uint32_t        flags;
+};
+
+struct CVPackFont
+{
+    uint32_t        tagOffset;
+    uint32_t        tagSize;
+    uint64_t        offset;
+    uint64_t        size;
+};
+
+/** @brief Read-only view of an asset pack, memory mapped from disk
+  *
+  * Page pixels and font files are read in place from the mapping, so
+  * the pack must stay open while fonts loaded from it are in use.
+  * FontManager::addPack keeps a shared reference for this reason.
+  */
+
+class CVISION_API CVAssetPack
+{
+public:
+
+    CVISION_API bool open(const std::string& fileName);
+    CVISION_API void close();
+    inline bool isOpen() const noexcept{ return data != nullptr; }
+
+    inline size_t numPages() const noexcept{ return pages.size(); }
+    inline size_t numImages() const noexcept{ return images.size(); }
+    inline size_t numFonts() const noexcept{ return fonts.size(); }
+
+    inline const CVPackPage& page(const size_t& index) const{ return pages[index]; }
+    inline const CVPackImage& image(const size_t& index) const{ return images[index]; }
+    inline const CVPackFont& font(const size_t& index) const{ return fonts[index]; }
+
+    CVISION_API const uint8_t* pagePixels(const size_t& index,
+                                          const unsigned int& level = 0) const;
+    CVISION_API sf::Vector2u pageLevelSize(const size_t& index,
+                                           const unsigned int& level) const;
+
+    CVISION_API std::string imageTag(const size_t& index) const;
+    CVISION_API std::string fontTag(const size_t& index) const;
+    inline const void* fontData(const size_t& index) const{ return data + fonts[index].offset; }
+
+    CVISION_API CVAssetPack();
+    CVISION_API ~CVAssetPack();
+
+protected:
+
+    const uint8_t*              data;
+    size_t                      size;
+
+#if defined WIN32 || defined _WIN32 || defined __WIN32
+    void*                       fileHandle;
+    void*                       mapHandle;
+#endif
+
+    std::vector<CVPackPage>     pages;
+    std::vector<CVPackImage>    images;
+    std::vector<CVPackFont>     fonts;
+    const char*                 strings;
+    uint32_t                    stringSize;
+
+    CVISION_API bool validate();
+
+    CVAssetPack(const CVAssetPack& other) = delete;
+    CVAssetPack& operator=(const CVAssetPack& other) = delete;
+
+};
+
+/** @brief Offline builder for asset packs
+  *
+  * Images are decoded once here and stored as raw RGBA.  In atlas mode,
+  * images up to the maximum item size share pages, and larger ones get a
+  * standalone page of their own.  Mip levels are box filtered on the CPU
+  * when enabled, down to CV_ATLAS_MIP_LEVELS on atlas pages.
+  */
+
+class CVISION_API CVAssetPackWriter
+{
+public:
+
+    CVISION_API bool addImage(const sf::Image& image, const std::string& tag);
+    CVISION_API bool addImage(const std::string& fileName, const std::string& tag);
+    CVISION_API bool addImage(const void* binaries, const size_t& size,
+                              const std::string& tag);
+
+    CVISION_API bool addFont(const std::string& fileName, const std::string& tag);
+    CVISION_API bool addFont(const void* binaries, const size_t& size,
+                             const std::string& tag);
+
+    CVISION_API void setAtlasMode(const bool& state,
+                                  const unsigned int& pageSize = 2048,
+                                  const unsigned int& maxItemSize = 256);
+    inline void setMipmaps(const bool& state) noexcept{ bMipmaps = state; }
+
+    CVISION_API bool write(const std::string& fileName);
+
+    CVISION_API CVAssetPackWriter();
+
+protected:
+
+    struct Entry
+    {
+        std::string             tag;
+        sf::Image               image;
+        std::vector<uint8_t>    bytes;      // Font file contents
+    };
+
+    std::vector<Entry> imageEntries;
+    std::vector<Entry> fontEntries;
+
+    bool bAtlas;
+    bool bMipmaps;
+    unsigned int atlasPageSize;
+    unsigned int atlasMaxItemSize;
+
+};
+
+}
+
+#endif // CVIS_ASSETPACK
@@ -0,0 +1,212 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_BATCH
+#define CVIS_BATCH
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <unordered_map>
+
+#include <SFML/Graphics.hpp>
+
+namespace cvis
+{
+
+/** @brief Triangle lists recorded for replay on another thread
+  *
+  * Holds the batches flushed by a recording CVRenderBatch together with
+  * the view each was drawn under.  Recording makes no OpenGL calls, so a
+  * frame can be built on the update thread and replayed into the window
+  * by the render thread.  Textures are referenced, not copied, and must
+  * outlive the replay.
+  */
+
+class CVISION_API CVDrawList
+{
+public:
+
+    CVISION_API CVDrawList();
+
+    CVISION_API void clear();
+    CVISION_API void add(const sf::View& view, const sf::Texture* texture,
+                         const std::vector<sf::Vertex>& vertices);
+
+    CVISION_API void replay(sf::RenderTarget& target) const;   // Restores the target's view when done
+
+    inline bool empty() const noexcept{ return commands.empty(); }
+    inline size_t size() const noexcept{ return commands.size(); }
+
+protected:
+
+    struct Command
+    {
+        sf::View                view;
+        const sf::Texture*      texture;
+        size_t                  first;      // Offset into the shared vertex list
+        size_t                  count;
+    };
+
+    std::vector<Command>        commands;
+    std::vector<sf::Vertex>     vertices;
+
+};
+
+/** @brief Render target that records a frame instead of drawing it
+  *
+  * Pass to CVRenderBatch::record() to collect a frame into a CVDrawList.
+  * The target answers view and coordinate queries like the window it
+  * stands in for.  Anything drawn to it directly would need OpenGL, so it
+  * is dropped and the frame is marked incomplete.
+  */
+
+class CVISION_API CVFrameRecorder : public sf::RenderTarget
+{
+public:
+
+    CVISION_API CVFrameRecorder();
+
+    CVISION_API void reset(const sf::Vector2u& size, const sf::View& view);    // Start a frame of [size] pixels
+
+    CVISION_API sf::Vector2u getSize() const override;
+    CVISION_API bool setActive(bool active = true) override;   // Only reached by draws that bypass the batch
+
+    inline bool complete() const noexcept{ return !bMissedDraw; }
+
+protected:
+
+    sf::Vector2u    size;
+    bool            bMissedDraw;    // Was anything drawn directly since reset()?
+
+};
+
+/** @brief Draw-call batching for shapes, sprites and text
+  *
+  * While collecting for a target, geometry is gathered into one triangle
+  * list per texture and submitted on flush().  An item joins an earlier
+  * batch of its texture only when no later batch has drawn into the
+  * screen cells it covers, so overlapping items keep their draw order.
+  * A change of the target's view, or any drawable that cannot be
+  * batched, flushes the pending batches first.
+  *
+  * record() collects for a target in the same way, but flush() appends
+  * the batches to a CVDrawList instead of drawing them.
+  */
+
+class CVISION_API CVRenderBatch
+{
+public:
+
+    struct Stats
+    {
+        size_t      drawCalls;  // Submissions to the render target
+        size_t      batches;    // Submissions that merged batched geometry
+        size_t      items;      // Shapes, sprites and texts merged into batches
+    };
+
+    CVISION_API CVRenderBatch();
+
+    CVISION_API bool begin(sf::RenderTarget* target);   // False if a batch is already open or suspended
+    CVISION_API bool record(sf::RenderTarget* target, CVDrawList* list);    // As begin(), flushing into [list]
+    CVISION_API void end();
+    CVISION_API void flush();
+
+    CVISION_API void suspend();     // Flush and draw straight to the target until resume()
+    CVISION_API void resume();
+
+    inline bool collecting(const sf::RenderTarget* target) const noexcept
+    {
+        return bCollecting && !suspendDepth && (target == this->target);
+    }
+    inline bool recording() const noexcept{ return recordList != nullptr; }
+
+    CVISION_API void draw(sf::RenderTarget* target, const sf::Shape& shape);
+    CVISION_API void draw(sf::RenderTarget* target, const sf::Sprite& sprite);
+    CVISION_API void draw(sf::RenderTarget* target, const sf::Text& text);
+    CVISION_API void draw(sf::RenderTarget* target, const sf::Drawable& drawable);   // Not batched
+
+    CVISION_API void beginFrame();  // Roll the frame statistics over
+    inline const Stats& frameStats() const noexcept{ return currentStats; }
+    inline const Stats& lastFrameStats() const noexcept{ return lastStats; }
+
+protected:
+
+    struct Batch
+    {
+        const sf::Texture*          texture;
+        std::vector<sf::Vertex>     vertices;
+    };
+
+    sf::RenderTarget*                                   target;
+    CVDrawList*                                         recordList;        // Receives flushed batches while recording
+    sf::View                                            batchView;
+    bool                                                bCollecting;
+    unsigned int                                        suspendDepth;
+
+    std::vector<Batch>                                  batches;
+    size_t                                              batchCount;
+    std::unordered_map<const sf::Texture*, size_t>      textureBatches;    // Latest open batch for each texture
+
+    std::vector<int>                                    cells;             // Latest batch drawn into each screen cell
+    unsigned int                                        gridWidth;
+    unsigned int                                        gridHeight;
+
+    std::vector<sf::Vertex>                             scratch;
+
+    Stats                                               currentStats;
+    Stats                                               lastStats;
+
+    CVISION_API void syncView();
+    CVISION_API void add(const sf::Texture* texture, const std::vector<sf::Vertex>& vertices);
+
+    CVRenderBatch(const CVRenderBatch& other) = delete;
+    CVRenderBatch& operator=(const CVRenderBatch& other) = delete;
+
+};
+
+}
+
+#endif // CVIS_BATCH
@@ -75,6 +75,10 @@ public:
     void updateTriggers() { }
 
     CVISION_API bool draw(sf::RenderTarget* target) override;
+    CVISION_API bool drawsBatched() const override;
+    CVISION_API bool shadowOutline(sf::Vector2f& size,
+                                   float& rounding,
+                                   uint8_t& corners) const override;
 
     CVISION_API void setPosition(const sf::Vector2f& position) override;
     inline void setPosition(const float& x, const float& y)
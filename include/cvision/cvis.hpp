@@ -66,5 +66,15 @@
 #include "cvision/templates/calendar.hpp"
 #include "cvision/templates/sketch.hpp"
 #include "cvision/table.hpp"
+#include "cvision/headless.hpp"
+#include "cvision/profiler.hpp"
+#include "cvision/threadpool.hpp"
+#include "cvision/input.hpp"
+#include "cvision/spatial.hpp"
+#include "cvision/batch.hpp"
+#include "cvision/loader.hpp"
+#include "cvision/assetpack.hpp"
+#include "cvision/imageops.hpp"
+#include "cvision/shadow.hpp"
 
 #endif // CVIS_HPP
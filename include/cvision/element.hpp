@@ -50,6 +50,7 @@
 #include <string>
 #include <cmath>
 #include <iostream>
+#include <memory>
 
 #include <SFML/Graphics.hpp>
 
@@ -57,6 +58,7 @@
 
 #include "cvision/trigger.hpp"
 #include "cvision/color.hpp"
+#include "cvision/import.hpp"
 
 // Action flags
 
@@ -161,6 +163,7 @@ public:
 
     CVISION_API const sf::Font* appFont(const std::string& font) const;
     CVISION_API const sf::Texture* appTexture(const std::string& tag) const;
+    CVISION_API CVTextureRegion appTextureRegion(const std::string& tag) const;     // Atlas page and sub-rect when packed
     CVISION_API const sf::Image* appImage(const std::string& tag) const;
     CVISION_API const sf::Color& appColor(const std::string& tag) const;
 
@@ -186,7 +189,39 @@ public:
     }
     inline void setVisible(bool visibleState)
     {
-        visible = visibleState;
+        if(visible != visibleState)
+        {
+            visible = visibleState;
+            invalidate();
+        }
+    }
+
+    /** @brief Flag this element as changed so that its view redraws on the next frame.
+      *
+      * The dirty state is propagated once per frame through the owning
+      * view panels up to the view.  Call this from custom elements
+      * whenever their drawn state changes outside of the standard
+      * setters (move, setSize, setFade, setColor, etc.).
+      */
+    CVISION_API void invalidate();
+    CVISION_API bool isDirty() const;   /**< @brief Has this element been invalidated during the current frame? */
+
+    /** @brief Flag the expanded bounds of the owning panels as stale.
+      *
+      * Marks each expanding ancestor dirty, stopping at the first one
+      * that is already dirty.  Stale bounds are recomputed once, when
+      * next read or on the panel's next update.  Called by invalidate().
+      */
+    CVISION_API void markBoundsDirty();
+    CVISION_API void invalidateBounds();    /**< @brief Flag this element's own expanded bounds as stale. */
+    inline bool boundsDirty() const noexcept{ return bBoundsDirty; }
+    inline void refreshBounds()
+    {
+        if(bBoundsDirty)
+        {
+            bBoundsDirty = false;
+            updateBounds();
+        }
     }
 
     CVISION_API float viewScale() const;
@@ -198,10 +233,7 @@ public:
 
     // ===================================================================== **/
 
-    inline void receive_trigger(const std::string& newTrigger)
-    {
-        incoming_triggers.emplace_back(newTrigger);
-    }
+    CVISION_API void receive_trigger(const std::string& newTrigger);
     CVISION_API std::string take_trigger(const std::string& newTrigger); // Attempt to get a trigger and extract its information
     inline bool trigger_waiting() const{ return !incoming_triggers.empty(); }
 
@@ -392,7 +424,7 @@ public:
     // ===================================================================== **/
 
     inline const std::string& tag() const noexcept{ return IDtag; } /**< @brief Get the unique ID assigned to this element. */
-    inline void setTag(const std::string& newTag) noexcept{ IDtag = newTag; } /**< @brief Set a unique ID for this element. */
+    CVISION_API void setTag(const std::string& newTag); /**< @brief Set a unique ID for this element. */
 
     /** ========================================================================
 
@@ -407,8 +439,15 @@ public:
     inline void setPosition(const float& posX, const float& posY) noexcept{ setPosition(sf::Vector2f(posX, posY)); }
 
     CVISION_API virtual void setExpand(const bool& state);
-    inline const sf::FloatRect& getBounds() const noexcept{ return bounds; }
+    inline const sf::FloatRect& getBounds() const noexcept
+    {
+        // Bounds are cached and resolved lazily.  Parallel updates resolve the
+        // batch and its container first, so workers only refresh their own subtree
+        if(bBoundsDirty) const_cast<CVElement*>(this)->refreshBounds();
+        return bounds;
+    }
     inline const sf::FloatRect& getGlobalBounds() const { return getBounds(); } /**< @brief Interface with templated SFML functions. */
+    CVISION_API sf::FloatRect getViewBounds() const; /**< @brief Bounds in view coordinates, through any relative-layout panels. */
 
     CVISION_API virtual sf::Vector2f getPosition() const;
     inline const sf::Vector2f& getOrigin() const noexcept{ return origin; }
@@ -483,6 +522,8 @@ public:
                    const sf::IntRect& subRect = sf::IntRect(0, 0, 0, 0));       // Add a new sprite
     CVISION_API void removeSprites(const std::string& tag);                         // Remove all sprites with this tag
     CVISION_API bool has_sprite(const std::string& tag) const;                     // Check if a sprite of this type has been added
+    CVISION_API void setSpriteTexture(sf::Sprite& sprite,
+                                      const sf::Texture* texture) const;            // Use the atlas region of the texture if packed
 
     inline const std::vector<sf::Sprite>& sprites() const
     {
@@ -536,8 +577,29 @@ public:
     }
 
     CVISION_API virtual bool update(CVEvent& event, const sf::Vector2f& mousePos); // Core update function for time-dependent activities (ie. Animations)
+    CVISION_API virtual bool needsUpdate() const; // Has per-frame state to advance even when the mouse is elsewhere
+
+    inline void setSkipWhenIdle(const bool& state = true) noexcept{ bSkipWhenIdle = state; }  // See CVViewPanel::setSpatialIndex
+    inline bool skipsWhenIdle() const noexcept{ return bSkipWhenIdle; }
     CVISION_API virtual bool draw(sf::RenderTarget* target);
 
+    /** @brief Can this element's draw() be collected into the view's render batch?
+      *
+      * Only true for classes whose draw() routes every item through
+      * CVView::renderBatch.  Subclasses that draw anything directly must
+      * not inherit it, so implementations compare the exact dynamic type.
+      */
+    CVISION_API virtual bool drawsBatched() const;
+
+    /** @brief Rounded-rectangle outline used to draw a shared drop shadow
+      *
+      * Elements which return false are captured from their rendered state
+      * by setDropShadow() instead, with a texture of their own.
+      */
+    CVISION_API virtual bool shadowOutline(sf::Vector2f& size,
+                                           float& rounding,
+                                           uint8_t& corners) const;
+
     CVISION_API virtual void getTexture(sf::Texture& output,
                                         const sf::Color& canvas_color = sf::Color::Transparent); // Get an image of the current draw state
     CVISION_API bool saveImage(const std::string& save_file);
@@ -561,6 +623,8 @@ public:
         brighten(highlightColor, 40);
 
         spriteColor = newColor;
+
+        invalidate();
     }
     inline void setColor(const int& r, const int& g, const int& b)
     {
@@ -601,6 +665,8 @@ public:
 
 protected:
 
+    friend class CVView;
+
     /** ========================================================================
 
         Flags
@@ -637,6 +703,9 @@ protected:
 
     bool bStatic;            /**< Cannot be moved */
     bool bNoInteract;        /**< Skip update cycles (enhance overall performance if this element is not being used/drawn) */
+    bool bIndexed;           /**< Registered in the view's tag index */
+    bool bBoundsDirty;       /**< Expanded bounds are stale and must be recomputed before use */
+    bool bSkipWhenIdle;      /**< A spatially indexed panel may skip update() while idle and away from the mouse */
 
     /** ========================================================================
 
@@ -661,6 +730,7 @@ protected:
     std::vector<sf::Sprite>         spriteList;         /**< Sprites under the control of this element, add to this list (ie. pawns) */
     sf::Texture                     clipTexture;        /**< Texture draw target for clipping */
     sf::Texture                     dropShadowTexture;  /**< Texture for drop shadow if applicable */
+    std::shared_ptr<const sf::Texture> sharedShadowTexture; /**< Drop shadow shared through CVView::shadowCache */
 
     sf::Sprite                      shadow;             /**< Shadow of this item: use for drag and drop, etc. */
     sf::Sprite                      drawMask;           /**< Clipping mask if region outside of bounds is to be excluded from the render */
@@ -684,6 +754,18 @@ protected:
     sf::Vector2f                    velocity;
     sf::Vector2f                    acceleration;   /**< Absolute acceleration (ie. gravity, buoyancy) */
 
+    sf::Vector2f                    physicsPosition;        /**< Simulated position at the latest fixed step */
+    sf::Vector2f                    physicsLastPosition;    /**< Simulated position at the previous fixed step */
+    sf::Vector2f                    physicsRenderPosition;  /**< Interpolated position drawn this frame */
+
+    CVISION_API void stepMotion(const float& timeStep);    /**< Advance movement by one fixed simulation step */
+
+    /** @brief Position in the fixed-step simulation, which leads the drawn (interpolated) position while moving */
+    inline sf::Vector2f simulatedPosition() const
+    {
+        return (bMove && (getPosition() == physicsRenderPosition)) ? physicsPosition : getPosition();
+    }
+
     float                           fMoveAngle;
     float                           fElasticity;    /**< 0 - 1; how much momentum is conserved during bounce interactions */
     float                           fFriction;      /**< coefficient of friction translating to -pixels/s^2 */
@@ -699,9 +781,14 @@ protected:
 
     int                             fadeRate;
 
+    size_t                          dirtyFrame;     /**< View frame index at which this element was last invalidated */
+
     sf::FloatRect                   bounds;
     CVISION_API virtual void updateBounds();
 
+    CVISION_API void drawChild(CVElement* element, sf::RenderTarget* target);  // Draw outside of the render batch if it cannot join
+    CVISION_API void drawSprites(sf::RenderTarget* target);                     // Draw the sprite list, loading lazy textures as needed
+
     KeyMapping                      controls;
 
     /** ========================================================================
@@ -718,6 +805,37 @@ protected:
 
 };
 
+/** @brief Scoped limit on invalidate() propagation for the current thread
+  *
+  * While elements are updated in parallel, their invalidation stops at
+  * [container] instead of writing to the shared parent panel.  Check
+  * reached() and boundsReached() afterwards and invalidate the container
+  * or its bounds from the view thread.
+  */
+class CVISION_API CVInvalidationBoundary
+{
+public:
+
+    CVISION_API CVInvalidationBoundary(const CVElement* container);
+    CVISION_API ~CVInvalidationBoundary();
+
+    inline bool reached() const noexcept{ return bReached; }
+    inline bool boundsReached() const noexcept{ return bBoundsReached; }
+
+private:
+
+    friend class CVElement;
+
+    const CVElement*            container;
+    CVInvalidationBoundary*     previous;
+    bool                        bReached;
+    bool                        bBoundsReached;
+
+    CVInvalidationBoundary(const CVInvalidationBoundary& other) = delete;
+    CVInvalidationBoundary& operator=(const CVInvalidationBoundary& other) = delete;
+
+};
+
 }
 
 #endif // CVIS_ELEMENT
@@ -299,6 +299,7 @@ public:
     }
 
     CVISION_API void moveCapturedShapes(); // Move captured shapes using mouse frame distance
+    CVISION_API void translateMouse(const sf::Vector2f& offset); // Shift recorded view-space mouse positions into a panel's member space
 
 
     CVISION_API float mouseVelocity() const;
@@ -366,6 +367,8 @@ public:
     CVISION_API bool focusFree();   // Check focus availability without stealing away from lower panels
     CVISION_API void reset();
 
+    CVISION_API void mergeChanges(const CVEvent& base, const CVEvent& result); // Apply the changes that [result] made to its copy of [base] (parallel update)
+
     CVISION_API bool leftClick(const float& duration = 0.0f) const;
     CVISION_API bool rightClick(const float& duration = 0.0f) const;
 
@@ -0,0 +1,147 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_HEADLESS
+#define CVIS_HEADLESS
+
+#include <deque>
+#include <string>
+
+#include <SFML/Graphics.hpp>
+
+#include "cvision/view.hpp"
+
+namespace cvis
+{
+
+/** @brief Off-screen CVView for benchmarks and automated tests
+  *
+  * Hosts the same panel/element tree as a regular CVView but
+  * never creates a native window.  Frames are advanced manually
+  * with step() using a fixed frame time, and input is supplied
+  * as a synthetic stream of SFML events that passes through the
+  * regular CVEvent translation in handleViewEvents.
+  *
+  * Rendering goes to an sf::RenderTexture and can be disabled
+  * entirely to measure update throughput alone.  Rendered frames
+  * can be saved to PNG on request or automatically after every
+  * step for pixel comparison.
+  *
+  * Note that fonts and textures still require an OpenGL context
+  * (created by CVApp), so on machines without a display the
+  * process must have access to an off-screen GL implementation
+  * (ie. a virtual framebuffer).
+  */
+
+class CVISION_API CVHeadlessView : public CVView
+{
+public:
+
+    CVISION_API CVHeadlessView(unsigned int x, unsigned int y,
+                               CVApp* mainApp,
+                               const bool& render = true,
+                               const sf::Color& backgroundColor = sf::Color::Black);
+
+    /** @brief Advance the view by a number of frames.
+      *
+      * Each frame drains the synthetic event queue, runs the
+      * update cascade with [frameTime] as the elapsed time and,
+      * if rendering is enabled, draws into the off-screen target.
+      *
+      * @return the number of frames actually processed (fewer if the view closed)
+      */
+    CVISION_API unsigned int step(const unsigned int& frames = 1,
+                                  const float& frameTime = 1.0f/60);
+
+    // Synthetic input
+
+    CVISION_API void postEvent(const sf::Event& event);    // Queue a raw event for the next step
+    CVISION_API void moveMouse(const sf::Vector2f& position);
+    CVISION_API void pressMouse(const sf::Mouse::Button& button = sf::Mouse::Left);
+    CVISION_API void releaseMouse(const sf::Mouse::Button& button = sf::Mouse::Left);
+    CVISION_API void click(const sf::Vector2f& position,
+                           const sf::Mouse::Button& button = sf::Mouse::Left);
+    CVISION_API void scrollWheel(const float& delta,
+                                 const sf::Mouse::Wheel& wheel = sf::Mouse::VerticalWheel);
+    CVISION_API void pressKey(const sf::Keyboard::Key& key);
+    CVISION_API void typeText(const std::string& text);
+
+    inline size_t numQueuedEvents() const noexcept{ return syntheticEvents.size(); }
+    inline const sf::Vector2f& getMousePosition() const noexcept{ return mousePos; }
+
+    // Frame output
+
+    inline void setRender(const bool& state = true) noexcept{ bRender = state; }
+    inline const bool& rendering() const noexcept{ return bRender; }
+
+    CVISION_API void setFrameOutput(const std::string& directory);    // Save every rendered frame as [directory]/frame_N.png (empty to disable)
+    CVISION_API bool saveFrame(const std::string& filename) const;    // Save the last rendered frame
+
+    inline const sf::Texture& getFrameTexture() const{ return renderTarget.getTexture(); }
+
+    CVISION_API bool window_open() const override;
+
+protected:
+
+    bool                    bRender;            // Draw into the off-screen target on each step
+    bool                    bOpen;
+
+    std::string             frameOutput;        // Directory for automatic frame dumps
+
+    std::deque<sf::Event>   syntheticEvents;
+    sf::Vector2f            syntheticMousePos;  // Cursor as of the last queued move, for stamping queued button events
+    sf::RenderTexture       renderTarget;
+
+    CVISION_API bool pollViewEvent(sf::Event& event) override;
+    CVISION_API bool hasViewFocus() const override;
+    CVISION_API sf::Vector2f getGlobalMousePosition() const override;
+
+    CVISION_API void renderFrame();
+
+};
+
+}
+
+#endif // CVIS_HEADLESS
@@ -0,0 +1,187 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_IMAGEOPS
+#define CVIS_IMAGEOPS
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <SFML/Graphics.hpp>
+
+namespace cvis
+{
+
+class CVThreadPool;
+
+/** @brief Mutable view of a block of tightly or loosely packed RGBA pixels */
+
+struct CVISION_API CVImageSpan
+{
+    uint8_t*        pixels;
+    unsigned int    width;
+    unsigned int    height;
+    size_t          stride;         // Bytes from one row to the next
+
+    inline uint8_t* row(const unsigned int& y) const noexcept{ return pixels + y*stride; }
+    inline uint8_t* at(const unsigned int& x, const unsigned int& y) const noexcept{ return pixels + y*stride + x*4; }
+
+    CVImageSpan(uint8_t* pixels,
+                const unsigned int& width,
+                const unsigned int& height,
+                const size_t& stride = 0):
+                    pixels(pixels),
+                    width(width),
+                    height(height),
+                    stride(stride ? stride : size_t(width)*4) { }
+
+    inline CVImageSpan(std::vector<uint8_t>& buffer, const unsigned int& width, const unsigned int& height):
+        CVImageSpan(buffer.data(), width, height) { }
+
+    // Sub-region, clipped to the span
+
+    CVImageSpan clip(const sf::IntRect& bounds) const noexcept;
+};
+
+/* Span over an image's own pixels, for operating in place.  Empty if the
+   image is empty */
+CVISION_API CVImageSpan imageSpan(sf::Image& image);
+
+/** ========================================================================
+
+    Pixel operations
+
+    These work a row at a time on contiguous pixels, 16 bytes per step
+    where SSE2 is available.  A thread pool splits large images into
+    strips of rows.
+
+// ===================================================================== **/
+
+CVISION_API void fill(CVImageSpan image,
+                      const sf::Color& color,
+                      CVThreadPool* pool = nullptr);
+
+/* Replace the colour channels, keeping each pixel's alpha */
+CVISION_API void recolor(CVImageSpan image,
+                         const sf::Color& color,
+                         CVThreadPool* pool = nullptr);
+
+/* Multiply each channel by the colour, as a sprite colour would */
+CVISION_API void tint(CVImageSpan image,
+                      const sf::Color& color,
+                      CVThreadPool* pool = nullptr);
+
+CVISION_API void premultiplyAlpha(CVImageSpan image,
+                                  CVThreadPool* pool = nullptr);
+
+/* Move each pixel toward the colour by its 8 bit coverage, where coverage
+   holds one byte per pixel with rows coverageStride bytes apart */
+CVISION_API void fillCoverage(CVImageSpan image,
+                              const uint8_t* coverage,
+                              const size_t& coverageStride,
+                              const sf::Color& color,
+                              CVThreadPool* pool = nullptr);
+
+/* Copy source into image at (x, y), clipped to both.  Blending composites
+   the source over the image by its alpha, matching sf::Image::copy */
+CVISION_API void blit(CVImageSpan image,
+                      const CVImageSpan& source,
+                      const int& x,
+                      const int& y,
+                      const bool& blend = false,
+                      CVThreadPool* pool = nullptr);
+
+/* Write source into output at offset, filling the rest of output with the
+   background in the same pass */
+CVISION_API void expandCanvas(const CVImageSpan& source,
+                              CVImageSpan output,
+                              const sf::Vector2i& offset,
+                              const sf::Color& background,
+                              CVThreadPool* pool = nullptr);
+
+/** ========================================================================
+
+    Flood fill
+
+    Fills the region connected to the seed whose pixels are within the
+    tolerance of the seed's colour on every channel.  Neighbours share an
+    edge, or also a corner if diagonal.  Runs of a row are scanned and
+    filled whole.  Returns the bounds of the filled region.
+
+// ===================================================================== **/
+
+CVISION_API sf::IntRect floodFill(CVImageSpan image,
+                                  const sf::Vector2i& seed,
+                                  const sf::Color& color,
+                                  const unsigned int& tolerance = 0,
+                                  const bool& diagonal = false);
+
+/** ========================================================================
+
+    Blur
+
+    Each channel is blurred independently, with edge pixels extended past
+    the borders.  Blur premultiplied pixels where transparent regions
+    should not bleed their colour.  A thread pool splits the passes into
+    strips of rows or columns on large images.
+
+// ===================================================================== **/
+
+CVISION_API void boxBlur(CVImageSpan image,
+                         const unsigned int& radius,
+                         CVThreadPool* pool = nullptr);
+
+/* Approximates a Gaussian of standard deviation sigma with three box
+   passes, so the cost per pixel does not depend on the radius */
+CVISION_API void gaussianBlur(CVImageSpan image,
+                              const float& sigma,
+                              CVThreadPool* pool = nullptr);
+
+}
+
+#endif // CVIS_IMAGEOPS
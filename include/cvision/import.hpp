@@ -46,8 +46,15 @@
 #ifndef CVIS_IMPORT
 #define CVIS_IMPORT
 
+#include <map>
+#include <list>
+#include <climits>
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 #include <unordered_map>
 
 #include "cvision/lib.hpp"
@@ -57,11 +64,14 @@
 namespace cvis
 {
 
+class CVAssetPack;
+
 class CVISION_API FontManager
 {
 public:
 
     std::unordered_map<std::string, sf::Font*> fonts;
+    std::vector<std::shared_ptr<const CVAssetPack>> packs;     // Backing memory for fonts loaded from packs
 
     inline const sf::Font* operator[](const std::string& s) const
     {
@@ -78,14 +88,91 @@ public:
     CVISION_API bool addFont(const std::string& fileDir, const std::string& tag);
     CVISION_API bool addFont(const void* binaries, const size_t& size,
                  const std::string& tag);
+    CVISION_API bool addFont(sf::Font* font, const std::string& tag);     // Takes ownership of a loaded font
+    CVISION_API size_t addPack(const std::shared_ptr<const CVAssetPack>& pack); // Returns the number of fonts added
 
     FontManager() { }
     ~FontManager();
 
 };
 
-typedef std::vector<sf::Texture> TextureList;
-typedef std::vector<sf::Image> ImageList;
+typedef std::vector<std::unique_ptr<sf::Texture>> TextureList;  // Owned individually so that handed out pointers stay valid
+typedef std::vector<std::unique_ptr<sf::Image>> ImageList;
+
+/** @brief A texture and the sub-rect of it occupied by an image */
+
+struct CVISION_API CVTextureRegion
+{
+    const sf::Texture*  texture;
+    sf::IntRect         rect;
+};
+
+#define CV_ATLAS_MIP_LEVELS             3   // Mip levels of an atlas page below the base
+#define CV_ATLAS_PADDING                (1 << CV_ATLAS_MIP_LEVELS)  // Keeps items apart down to the smallest level
+
+/** @brief Shelf allocator for packing rectangles into square pages
+  *
+  * Rectangles are placed left to right on horizontal shelves, choosing the
+  * open shelf which wastes the least height.  A new shelf is opened below
+  * the last when none fit, and a new page when the last page is full.
+  * With an alignment of 2^n, every rectangle starts on a texel of mip
+  * level n, so padding of 2^n keeps neighbours apart through that level.
+  */
+
+class CVISION_API CVShelfPacker
+{
+public:
+
+    CVISION_API bool insert(const sf::Vector2u& size,
+                            unsigned int& page,
+                            sf::Vector2u& position);        // False if the size can never fit a page
+
+    CVISION_API void setPageSize(const unsigned int& newSize);  // Applies to pages opened afterwards
+    inline const unsigned int& getPageSize() const noexcept{ return pageSize; }
+    inline unsigned int getPageSize(const size_t& page) const{ return pages[page].size; }
+    inline size_t numPages() const noexcept{ return pages.size(); }
+
+    CVISION_API void clear();
+
+    CVISION_API CVShelfPacker(const unsigned int& pageSize = 2048,
+                              const unsigned int& padding = 2,
+                              const unsigned int& alignment = 1);
+
+protected:
+
+    struct Shelf
+    {
+        unsigned int top;
+        unsigned int height;
+        unsigned int width;         // Used width
+    };
+
+    struct Page
+    {
+        unsigned int        size;
+        unsigned int        height; // Height claimed by shelves
+        std::vector<Shelf>  shelves;
+    };
+
+    unsigned int pageSize;
+    unsigned int padding;           // Keeps smoothed neighbours from bleeding into each other
+    unsigned int alignment;         // Rectangles start on multiples of this
+
+    std::vector<Page> pages;
+
+};
+
+/** @brief Usage counters for lazily loaded textures */
+
+struct CVISION_API CVTextureCacheStats
+{
+    size_t hits;            // Uses of a resident texture
+    size_t misses;          // Uses which had to decode the texture
+    size_t evictions;
+    size_t failures;        // Sources which could not be decoded
+    size_t residentBytes;   // Estimated, including mipmaps
+    size_t budgetBytes;     // 0: unlimited
+};
 
 class CVISION_API ImageManager
 {
@@ -98,30 +185,147 @@ protected:
     std::vector<std::string> imageTags;
     unsigned int numImages;
 
+    std::unordered_map<std::string, unsigned int> textureIndex;         // Tag to handle (first added wins)
+    std::unordered_map<std::string, unsigned int> imageIndex;
+    std::unordered_map<const sf::Texture*, unsigned int> textureHandles; // Texture to handle
+
+    bool bAtlas;
+    unsigned int atlasMaxItemSize;
+
+    CVShelfPacker atlasPacker;
+    TextureList atlasPages;
+    TextureList packPages;                          // Shared pages uploaded from asset packs
+    std::vector<CVTextureRegion> atlasRegions;      // Per texture index; null texture if not packed
+    std::map<std::pair<const sf::Texture*, std::pair<int, int>>, unsigned int> atlasTags; // Page and origin to texture index
+
+    CVISION_API bool packTexture(const sf::Image& image); // Pack the texture about to be registered into an atlas page if it is small enough
+
+    CVISION_API void registerTexture(std::unique_ptr<sf::Texture>& texture, const std::string& tag); // Call with textureLock held
+
+    inline unsigned int findTexture(const sf::Texture* texture) const // textureHandle() without locking
+    {
+        auto it = textureHandles.find(texture);
+        return it == textureHandles.end() ? npos : it->second;
+    }
+    CVISION_API CVTextureRegion findRegion(const sf::Texture* texture) const; // textureRegion() without locking
+
+    struct LazyTexture
+    {
+        std::string                         fileName;
+        const void*                         binaries;
+        size_t                              size;
+        sf::Vector2u                        imageSize;  // From the source header, so sprites are sized before decoding
+
+        bool                                bResident;
+        size_t                              bytes;
+        std::chrono::steady_clock::time_point lastUse;
+        std::list<unsigned int>::iterator   lruPos;     // Valid while resident
+    };
+
+    std::unordered_map<unsigned int, LazyTexture> lazyTextures;     // Handle to source
+    std::list<unsigned int> lazyLRU;                                // Resident lazy handles, most recent first
+    std::atomic<size_t> numLazy;
+    mutable std::mutex textureLock;                                 // Texture tables and lazy state; sprites touch textures from update threads
+
+    CVTextureCacheStats cacheStats;
+    std::chrono::duration<float> evictionDelay;
+
+    CVISION_API bool decodeLazy(const unsigned int& handle, LazyTexture& lazy);
+    CVISION_API void evictLazy(const unsigned int& handle, LazyTexture& lazy);
+    CVISION_API void trimLazy();
+
 public:
+
+    static constexpr unsigned int npos = UINT_MAX;  // Invalid handle
+
     inline const sf::Texture* indexTexture(const unsigned int i) const
     {
-        return &textures[i];
+        return i < numTextures ? textures[i].get() : nullptr;
     }
     inline const sf::Image* indexImage(const unsigned int i) const
     {
-        return &images[i];
+        return i < numImages ? images[i].get() : nullptr;
     }
 
+    CVISION_API unsigned int textureHandle(const std::string& tag) const;           // npos if not found
+    CVISION_API unsigned int textureHandle(const sf::Texture* texture) const;
+    CVISION_API unsigned int imageHandle(const std::string& tag) const;
+
     CVISION_API const sf::Texture* taggedTexture(const std::string& s) const;
     CVISION_API const sf::Image* taggedImage(const std::string& s) const;
 
     CVISION_API std::string getTextureName(const sf::Texture* texture) const;
+    CVISION_API std::string getTextureName(const sf::Texture* texture, const sf::IntRect& rect) const; // Also resolves atlas sub-rects
+
+    /** @brief Pack small textures into shared atlas pages as they are added
+      *
+      * textureRegion() returns the atlas page and sub-rect for packed
+      * textures, so that sprites of different icons share a texture and can
+      * be batched.  Pages carry CV_ATLAS_MIP_LEVELS mip levels, padded so
+      * that minified icons do not bleed into each other.  Packed textures
+      * remain available on their own through taggedTexture() for whole
+      * texture uses such as masks and cursors, but without mipmaps.
+      */
+    CVISION_API void setAtlasMode(const bool& state,
+                                  const unsigned int& pageSize = 2048,
+                                  const unsigned int& maxItemSize = 256);
+    inline const bool& atlasMode() const noexcept{ return bAtlas; }
+    inline size_t numAtlasPages() const noexcept{ return atlasPages.size() + packPages.size(); }
+
+    CVISION_API CVTextureRegion textureRegion(const std::string& tag) const;
+    CVISION_API CVTextureRegion textureRegion(const sf::Texture* texture) const;
 
     CVISION_API bool addImage(std::string fileName, std::string tag);
     CVISION_API bool addTexture(std::string fileName, std::string tag);
 
     CVISION_API bool addTexture(const void* binaries, const size_t& size,
                     const std::string& tag);
+    CVISION_API bool addTexture(const sf::Image& image, const std::string& tag);   // Upload a decoded image
+
+    /** @brief Register a texture which is decoded on first use
+      *
+      * The returned texture pointer is stable, but the texture stays empty
+      * until touch() is called on it.  The image size is read from the
+      * source header here, so textureRegion() can size sprites without
+      * decoding, and CVElement::drawSprites touches them when they are
+      * first drawn.  Formats without a readable header (TGA, HDR, PIC) are
+      * decoded once here to find their size.  Once resident
+      * textures exceed the budget, the least recently used lazy textures
+      * are released again.  Textures used within the eviction delay are
+      * kept, so a frame which is still being drawn never loses its textures.
+      * Binaries must outlive the manager.
+      */
+    CVISION_API bool addLazyTexture(const std::string& fileName, const std::string& tag);
+    CVISION_API bool addLazyTexture(const void* binaries, const size_t& size,
+                                    const std::string& tag);
+
+    CVISION_API void touch(const sf::Texture* texture);                 // Mark as used, decoding a lazy texture if needed
+    inline bool hasLazyTextures() const noexcept{ return numLazy > 0; }
+
+    CVISION_API void setTextureBudget(const size_t& bytes);                     // 0: unlimited
+    CVISION_API void setEvictionDelay(const float& seconds);
+    CVISION_API CVTextureCacheStats textureCacheStats();
+    CVISION_API void resetTextureCacheStats();
+    CVISION_API bool addImage(std::unique_ptr<sf::Image> image, const std::string& tag);
+
+    /** @brief Upload every image of an asset pack as a texture
+      *
+      * Pixels are uploaded straight from the mapped pack without decoding,
+      * along with any mip levels it carries.  Atlas pages in the pack are
+      * kept as atlas pages here, so textureRegion() resolves their images
+      * to the page and sub-rect.  Returns the number of textures added.
+      */
+    CVISION_API size_t addPack(const CVAssetPack& pack);
 
     ImageManager():
         numTextures(0),
-        numImages(0) { }
+        numImages(0),
+        bAtlas(false),
+        atlasMaxItemSize(256),
+        atlasPacker(2048, CV_ATLAS_PADDING, CV_ATLAS_PADDING),
+        numLazy(0),
+        cacheStats({ 0, 0, 0, 0, 0, 0 }),
+        evictionDelay(0.1f) { }
     ~ImageManager() { }
 
 };
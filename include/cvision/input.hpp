@@ -0,0 +1,154 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_INPUT
+#define CVIS_INPUT
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+
+#include <SFML/Graphics.hpp>
+
+namespace cvis
+{
+
+/** @brief An OS event stamped with the time it was queued */
+struct CVInputEvent
+{
+    uint64_t                    time;           /**< Microseconds since the queue (or recording) started */
+    sf::Event                   event;
+};
+
+/** @brief Input state sampled at the start of a single view frame */
+struct CVInputFrame
+{
+    uint64_t                    time;           /**< Microseconds since the recording started */
+    float                       frameTime;      /**< Frame time applied to the view (s) */
+
+    sf::Vector2i                mousePosition;          /**< Pointer position relative to the view */
+    sf::Vector2i                globalMousePosition;    /**< Pointer position on the desktop */
+    bool                        focus;
+
+    std::vector<CVInputEvent>   events;         /**< Events dispatched during the frame, in order */
+};
+
+/** @brief Timestamped view input queue with record and replay
+  *
+  * Each CVView drains its OS events into this queue once per frame.
+  * Consecutive mouse moves that have not yet been dispatched are
+  * coalesced into the latest one.  While recording, every frame's
+  * sampled input and dispatched events are kept and can be saved to a
+  * compact binary file.  A loaded recording can be replayed into the
+  * view frame by frame, using the recorded frame times, so that a
+  * session is reproduced exactly regardless of how fast it runs.
+  */
+
+class CVISION_API CVInputQueue
+{
+public:
+
+    CVISION_API CVInputQueue();
+
+    // Live input
+
+    CVISION_API void push(const sf::Event& event);      // Timestamp and enqueue an event
+    CVISION_API bool pop(sf::Event& event);             // Dispatch the next event, recording it if enabled
+    CVISION_API void clear();
+
+    inline bool empty() const noexcept{ return pending.empty(); }
+    inline size_t size() const noexcept{ return pending.size(); }
+
+    // Recording
+
+    CVISION_API void startRecording();
+    CVISION_API void stopRecording();
+    inline const bool& recording() const noexcept{ return bRecording; }
+
+    CVISION_API void beginFrame(const float& frameTime,             // Sample live input for a new frame (recorded if enabled)
+                                const sf::Vector2i& mousePosition,
+                                const sf::Vector2i& globalMousePosition,
+                                const bool& focus);
+
+    inline const std::vector<CVInputFrame>& getFrames() const noexcept{ return frames; }
+
+    CVISION_API bool save(const std::string& filename) const;
+    CVISION_API bool load(const std::string& filename);
+
+    // Replay
+
+    CVISION_API bool startReplay();                     // Replay the recorded or loaded frames from the start
+    CVISION_API void stopReplay();
+    inline const bool& replaying() const noexcept{ return bReplaying; }
+
+    CVISION_API const CVInputFrame* nextFrame();        // Advance replay by a frame; nullptr once complete
+    inline const CVInputFrame* replayFrame() const noexcept{ return replayIndex ? &frames[replayIndex - 1] : nullptr; }
+
+protected:
+
+    bool                                bRecording;
+    bool                                bReplaying;
+
+    std::chrono::high_resolution_clock::time_point epoch;
+    std::chrono::high_resolution_clock::time_point recordStart;
+
+    std::deque<CVInputEvent>            pending;
+    std::vector<CVInputFrame>           frames;
+    size_t                              replayIndex;    // Frames replayed so far
+
+    inline uint64_t now(const std::chrono::high_resolution_clock::time_point& since) const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::high_resolution_clock::now() - since).count();
+    }
+
+};
+
+}
+
+#endif // CVIS_INPUT
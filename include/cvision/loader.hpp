@@ -0,0 +1,162 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_LOADER
+#define CVIS_LOADER
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#include <SFML/Graphics.hpp>
+
+namespace cvis
+{
+
+class CVApp;
+class CVProgressBar;
+
+/** @brief Decodes queued images and fonts on the app thread pool
+  *
+  * Files and embedded binaries are queued by tag, then decoded on worker
+  * threads by start().  Texture uploads and mipmap generation need a GL
+  * context, so upload() registers the decoded assets with the app from the
+  * calling thread, a batch at a time.  This lets a splash screen keep
+  * drawing between batches.  load() does both and blocks until finished.
+  */
+
+class CVISION_API CVAssetLoader
+{
+public:
+
+    enum AssetType
+    {
+        ASSET_TEXTURE = 0,
+        ASSET_IMAGE,
+        ASSET_FONT
+    };
+
+    CVISION_API void queue(const AssetType& type,
+                           const std::string& fileName,
+                           const std::string& tag);
+    CVISION_API void queue(const AssetType& type,
+                           const void* binaries,
+                           const size_t& size,
+                           const std::string& tag);     // Binaries must outlive the load
+
+    CVISION_API void start();                          // Begin decoding the queue in the background
+    CVISION_API size_t upload(const size_t& maxItems = 0); // Register decoded assets on this thread (0: all ready)
+    CVISION_API size_t load();                         // start(), then upload() until finished
+
+    CVISION_API bool finished() const;
+    CVISION_API float progress() const;                // Decoded and registered over total queued
+
+    inline size_t numQueued() const noexcept{ return total; }
+    inline size_t numLoaded() const noexcept{ return loaded; }
+    inline size_t numFailed() const noexcept{ return failed; }
+
+    // Called from the uploading thread after each batch
+
+    inline void setProgressCallback(const std::function<void(const float&)>& callback)
+    {
+        progressCallback = callback;
+    }
+    CVISION_API void bindProgressBar(CVProgressBar* bar);
+
+    CVISION_API CVAssetLoader(CVApp* app);
+    CVISION_API ~CVAssetLoader();
+
+protected:
+
+    struct Asset
+    {
+        AssetType                   type;
+        std::string                 tag;
+        std::string                 fileName;
+        const void*                 binaries;
+        size_t                      size;
+
+        bool                        bDecoded;
+        std::unique_ptr<sf::Image>  image;
+        std::unique_ptr<sf::Font>   font;
+    };
+
+    CVApp* mainApp;
+
+    std::vector<std::unique_ptr<Asset>> pending;    // Queued since the last start()
+    std::vector<std::unique_ptr<Asset>> decoding;
+
+    std::deque<Asset*>          ready;
+    mutable std::mutex          readyLock;
+    std::condition_variable     readySignal;
+
+    std::thread*                decodeThread;
+
+    std::atomic<size_t>         total;
+    std::atomic<size_t>         decoded;
+    std::atomic<size_t>         loaded;
+    std::atomic<size_t>         failed;
+
+    std::function<void(const float&)> progressCallback;
+
+    CVISION_API void decode(Asset& asset);
+    CVISION_API void join();
+
+    CVAssetLoader(const CVAssetLoader& other) = delete;
+    CVAssetLoader& operator=(const CVAssetLoader& other) = delete;
+
+};
+
+}
+
+#endif // CVIS_LOADER
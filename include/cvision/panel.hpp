@@ -95,6 +95,8 @@ public:
 
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
     CVISION_API bool draw(sf::RenderTarget* target);
+    CVISION_API bool drawsBatched() const override;
+    CVISION_API bool supportsRelativeLayout() const override;
 
     CVISION_API CVBasicViewPanel(CVView* parentView,
                                  const std::string& panelTag = "",
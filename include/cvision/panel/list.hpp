@@ -72,6 +72,7 @@ public:
 
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
     CVISION_API bool draw(sf::RenderTarget* target);
+    CVISION_API bool supportsRelativeLayout() const override;
 
     inline const float& getListPadding() const
     {
@@ -128,7 +128,7 @@ public:
     CVISION_API void setWeight(const float& newWeight,
                                const bool& rescale = true) noexcept;
     inline void setType(const std::string& newType) noexcept{ type = newType; }
-    CVISION_API void setTag(const std::string& newTag) noexcept;
+    CVISION_API void setTag(const std::string& newTag);
 
     inline void setTextDisplayOffset(const sf::Vector2f& newOffset) noexcept{ textDisplayOffset = newOffset; }
 
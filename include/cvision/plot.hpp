@@ -573,6 +573,7 @@ public:
 
     CVISION_API bool draw(sf::RenderTarget* target);
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
+    CVISION_API bool needsUpdate() const override;
 
     inline void callUpdate(const unsigned char& reqState = CV_PLOT_UPDATE_ALL){
         updateState |= reqState;
@@ -0,0 +1,206 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_PROFILER
+#define CVIS_PROFILER
+
+#include "cvision/lib.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <ostream>
+
+// Scoped timing shortcuts - cost a single flag check when profiling is disabled
+
+#define CV_PROFILE_CONCAT_IMPL(a, b)    a##b
+#define CV_PROFILE_CONCAT(a, b)         CV_PROFILE_CONCAT_IMPL(a, b)
+
+#define CV_PROFILE_SCOPE(profiler, name, category) \
+    cvis::CVProfileScope CV_PROFILE_CONCAT(cvProfileScope_, __LINE__)((profiler), (name), (category))
+
+#define CV_PROFILE_ELEMENT(profiler, element, category) \
+    cvis::CVProfileScope CV_PROFILE_CONCAT(cvProfileScope_, __LINE__)((profiler), (element), (category))
+
+namespace cvis
+{
+
+class CVElement;
+
+/** @brief A single timed region within a profiled frame */
+struct CVProfileSample
+{
+    const std::string*  name;       /**< Interned by the profiler, valid for its lifetime */
+    const char*     category;
+
+    unsigned int    depth;          /**< Nesting level in the App -> View -> Panel -> Element cascade */
+    size_t          parent;         /**< Index of the enclosing sample in the frame, or SIZE_MAX for roots */
+
+    double          start;          /**< Microseconds since the profiler epoch */
+    double          duration;       /**< Microseconds */
+};
+
+/** @brief All samples recorded between beginFrame() and endFrame() */
+struct CVProfileFrame
+{
+    size_t                          index;
+    double                          start;
+    double                          duration;
+    std::vector<CVProfileSample>    samples;
+};
+
+/** @brief Rolling per-frame update/draw profiler
+  *
+  * Each CVView owns one profiler, which is disabled by default.
+  * When enabled, scoped samples opened with CV_PROFILE_SCOPE or
+  * CV_PROFILE_ELEMENT are recorded as a tree per frame, and the
+  * most recent frames are kept in a ring of fixed capacity.  The
+  * ring can be exported as Chrome trace-event JSON (load with
+  * chrome://tracing or Perfetto).
+  *
+  * Enabling or disabling takes effect at the start of the next
+  * frame so that open samples are always balanced.  Only the thread
+  * that began the frame is recorded.
+  *
+  * getFrames() belongs to the view thread.  snapshot() and the trace
+  * exports copy the completed frames under a lock, and may be called
+  * from any thread while the view is running.  clear() and frame
+  * capacity changes are likewise applied by the view thread at the
+  * start of its next frame.
+  */
+
+class CVISION_API CVProfiler
+{
+public:
+
+    CVISION_API CVProfiler(const size_t& frameCapacity = 300);
+
+    inline bool enabled() const noexcept{ return bEnabled; }
+    inline void setEnabled(const bool& state = true) noexcept{ bRequested = state; }
+
+    CVISION_API void setFrameCapacity(const size_t& frameCapacity);
+    inline size_t getFrameCapacity() const noexcept{ return capacity; }
+
+    CVISION_API void beginFrame();
+    CVISION_API void endFrame();
+
+    CVISION_API size_t beginSample(const std::string& name, const char* category);
+    CVISION_API size_t beginSample(const CVElement& element, const char* category);
+    CVISION_API void endSample(const size_t& index);
+
+    inline const std::deque<CVProfileFrame>& getFrames() const noexcept{ return frames; }  // View thread only
+    CVISION_API std::deque<CVProfileFrame> snapshot() const;                                // Completed frames
+    CVISION_API void clear();                                                               // Deferred to the next frame
+
+    CVISION_API void writeChromeTrace(std::ostream& output,
+                                      const std::string& threadName = "") const;
+    CVISION_API bool exportChromeTrace(const std::string& filename,
+                                       const std::string& threadName = "") const;
+
+protected:
+
+    bool                        bEnabled;       // Recording state for the current frame
+    bool                        bFrameOpen;
+
+    std::atomic<bool>           bRequested;     // Recording state requested for the next frame
+    std::atomic<bool>           bClearRequested;
+
+    std::thread::id             owner;          // Samples from other threads (ie. parallel updates) are ignored
+
+    std::atomic<size_t>         capacity;
+    size_t                      frameCount;
+
+    std::chrono::high_resolution_clock::time_point epoch;
+
+    std::deque<CVProfileFrame>  frames;
+    std::vector<size_t>         openSamples;    // Stack of sample indices in the current frame
+    std::unordered_set<std::string> names;      // Interned sample names, view thread only
+
+    mutable std::mutex          framesLock;     // Held while frames are added, removed or closed
+
+    inline double now() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - epoch).count();
+    }
+
+};
+
+/** @brief RAII helper which times its own lifetime when profiling is enabled */
+class CVProfileScope
+{
+public:
+
+    inline CVProfileScope(CVProfiler& profiler, const char* name, const char* category):
+        profiler(profiler.enabled() ? &profiler : nullptr),
+        index(this->profiler ? profiler.beginSample(name, category) : SIZE_MAX) { }
+
+    inline CVProfileScope(CVProfiler& profiler, const CVElement* element, const char* category):
+        profiler(profiler.enabled() ? &profiler : nullptr),
+        index(this->profiler ? profiler.beginSample(*element, category) : SIZE_MAX) { }
+
+    inline ~CVProfileScope()
+    {
+        if(profiler) profiler->endSample(index);
+    }
+
+    CVProfileScope(const CVProfileScope& other) = delete;
+    CVProfileScope& operator=(const CVProfileScope& other) = delete;
+
+private:
+
+    CVProfiler*     profiler;
+    size_t          index;
+
+};
+
+}
+
+#endif // CVIS_PROFILER
@@ -0,0 +1,119 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_SHADOW
+#define CVIS_SHADOW
+
+#include "cvision/lib.hpp"
+
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+
+#include <SFML/Graphics.hpp>
+
+#define CV_CORNER_TOP_LEFT              0x01
+#define CV_CORNER_TOP_RIGHT             0x02
+#define CV_CORNER_BOTTOM_RIGHT          0x04
+#define CV_CORNER_BOTTOM_LEFT           0x08
+#define CV_CORNER_ALL                   0x0F
+
+namespace cvis
+{
+
+class CVThreadPool;
+
+/** @brief Blurred rounded-rectangle shadows shared between elements
+  *
+  * Shadows are rasterized on the CPU from the outline and blurred, so
+  * no render or texture readback is needed.  Elements with the same
+  * size, rounding, rounded corners and blur radius share one texture.
+  * The cache only holds weak references, so a texture is released when
+  * the last element using it drops its shadow.  The texture extends
+  * margin(radius) past the outline on every side.  It is white with
+  * coverage in alpha, so tint and opacity are applied by the sprite
+  * colour.
+  */
+
+class CVISION_API CVShadowCache
+{
+public:
+
+    CVISION_API std::shared_ptr<const sf::Texture> get(const sf::Vector2f& size,
+                                                       const float& rounding,
+                                                       const uint8_t& corners,
+                                                       const int& radius,
+                                                       CVThreadPool* pool = nullptr);
+
+    static inline int margin(const int& radius) noexcept{ return radius > 0 ? 2*radius : 0; }
+
+    CVISION_API size_t size();                 // Textures still in use
+    CVISION_API void clear();
+
+    inline size_t numHits() const noexcept{ return hits; }
+    inline size_t numMisses() const noexcept{ return misses; }
+
+    CVISION_API CVShadowCache();
+
+protected:
+
+    typedef std::tuple<int, int, int, int, uint8_t> Key;   // Width, height, rounding (1/4 px), radius, corners
+
+    std::map<Key, std::weak_ptr<const sf::Texture>> shadows;
+    std::mutex cacheLock;
+
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+
+    CVISION_API void prune();
+
+};
+
+}
+
+#endif // CVIS_SHADOW
@@ -0,0 +1,128 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_SPATIAL
+#define CVIS_SPATIAL
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+
+#include <SFML/Graphics.hpp>
+
+namespace cvis
+{
+
+class CVElement;
+
+/** @brief Uniform grid over element bounds for hit-testing
+  *
+  * Each element is binned into the cells its bounds overlap.  A point
+  * query only visits one cell, plus the short list of elements too large
+  * to bin.  Moved elements can be queued from any thread with markMoved()
+  * and are re-binned on the next flush().
+  */
+
+class CVISION_API CVSpatialGrid
+{
+public:
+
+    CVISION_API CVSpatialGrid(const float& cellSize = 64.0f);
+
+    CVISION_API void setCellSize(const float& newSize);     // Re-bins all entries
+    inline const float& getCellSize() const noexcept{ return cellSize; }
+
+    CVISION_API void insert(CVElement* element);
+    CVISION_API void remove(const CVElement* element);
+    CVISION_API void update(CVElement* element);            // Re-bin if the element bounds have changed
+    CVISION_API void clear();
+
+    CVISION_API void markMoved(CVElement* element);         // Defer re-binning to the next flush()
+    CVISION_API void flush();
+
+    /** @brief Append the elements whose bounds contain a point, in no particular order */
+    CVISION_API void query(const sf::Vector2f& point, std::vector<CVElement*>& output) const;
+
+    inline bool contains(const CVElement* element) const{ return entries.find(element) != entries.end(); }
+    inline size_t size() const noexcept{ return entries.size(); }
+
+protected:
+
+    struct Entry
+    {
+        sf::FloatRect               bounds;
+        sf::IntRect                 cells;
+        bool                        bOversized;
+        bool                        bPending;
+    };
+
+    float                                                   cellSize;
+
+    std::unordered_map<const CVElement*, Entry>             entries;
+    std::unordered_map<uint64_t, std::vector<CVElement*>>   cells;
+    std::vector<CVElement*>                                 oversized;     // Unbounded or spanning too many cells
+
+    std::vector<CVElement*>                                 pending;
+    std::mutex                                              pendingLock;
+
+    static inline uint64_t cellKey(const int& x, const int& y) noexcept
+    {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    }
+
+    CVISION_API void bin(CVElement* element, Entry& entry);
+    CVISION_API void unbin(const CVElement* element, Entry& entry);
+
+    CVSpatialGrid(const CVSpatialGrid& other) = delete;
+    CVSpatialGrid& operator=(const CVSpatialGrid& other) = delete;
+
+};
+
+}
+
+#endif // CVIS_SPATIAL
@@ -69,7 +69,16 @@ protected:
 
     const sf::Texture* icon;
 
-    bool bVisible;
+    std::vector<uint8_t> strokeCoverage;       // Packed rows of the stroke's spans
+    std::vector<sf::Vector2i> strokeSpans;      // Per row of the stroke: [x, y) columns of the image
+    std::vector<size_t> strokeOffsets;          // Per row of the stroke: start in strokeCoverage
+
+    unsigned int fillTolerance;
+
+    bool bVisible,
+        bDiagonalFill;
+
+    CVISION_API bool mouseColor(sf::Color& output) const; // Colour for the mouse button held, if any
 
 public:
 
@@ -90,10 +99,27 @@ public:
         connective
     } effect;
 
-    CVISION_API void drawToImage(sf::Image& image, const sf::Vector2i& coords);
-    CVISION_API void drawToImage(sf::Image& image,
+    // Returns the region of the image the brush may have touched
+
+    /* Rasterize a stroke segment between two points in image coordinates as
+       evenly spaced, anti-aliased dabs.  Coverage is merged per stroke and
+       applied in one pass, so overlapping dabs do not build up.  Only the
+       columns reached on each row are blended, and bands, if given,
+       receives a rect per group of rows touched for a tight upload.
+       Continued segments skip the dab at their start, already drawn by the
+       last one.  Connective point brushes flood fill from the segment's
+       end, once per stroke */
+    CVISION_API sf::IntRect drawStroke(sf::Image& image,
+                                       const sf::Vector2f& from,
+                                       const sf::Vector2f& to,
+                                       const sf::Color& color,
+                                       const bool& continued = false,
+                                       std::vector<sf::IntRect>* bands = nullptr);
+
+    CVISION_API sf::IntRect drawToImage(sf::Image& image, const sf::Vector2i& coords);
+    CVISION_API sf::IntRect drawToImage(sf::Image& image,
                      const std::vector<sf::Vector2i>& coords);
-    CVISION_API void drawToImage(sf::Image& image,
+    CVISION_API sf::IntRect drawToImage(sf::Image& image,
                      const std::vector<std::vector<int>>& coords);
 
     CVISION_API bool draw(sf::RenderTarget* target);
@@ -104,6 +130,9 @@ public:
     CVISION_API void setPrimaryColor(const sf::Color& newColor);
     CVISION_API void setSecondaryColor(const sf::Color& newColor);
 
+    inline const sf::Color& getPrimaryColor() const{ return primaryColor; }
+    inline const sf::Color& getSecondaryColor() const{ return secondaryColor; }
+
     CVISION_API const sf::Vector2f& getPosition() const;
     CVISION_API const sf::Vector2f& getDimensions() const;
     CVISION_API const sf::Vector2f& getDrawScale() const;
@@ -129,6 +158,12 @@ public:
     CVISION_API void setEffect(const CVBrushEffect& effect);
     CVISION_API void setType(const CVBrushType& type);
 
+    // Connective fills take pixels within the tolerance of the seed on every
+    // channel, joined by edges, or also by corners if diagonal
+
+    CVISION_API void setFillTolerance(const unsigned int& tolerance);
+    CVISION_API void setDiagonalFill(const bool& status = true);
+
     CVISION_API CVBrush(const sf::Color& color = sf::Color::Black,
             const float& radius = 1.0f,
             const float& rounding = 0.0f,
@@ -142,11 +177,15 @@ public:
 class CVISION_API CVSketchPanel : public CVBasicViewPanel{
 protected:
 
-    sf::Image drawCanvas;
+    // Layers keep their pixels on the CPU and upload the region drawn to
+    // since the last frame
 
     class CVISION_API CVSketchLayer : public sf::RectangleShape{
     protected:
+        sf::Image canvas;
         sf::Texture cachedTexture;
+        std::vector<sf::IntRect> dirtyRects;
+        std::vector<uint8_t> uploadBuffer;
         std::string tag;
         CVSketchPanel* host;
 
@@ -158,6 +197,16 @@ protected:
         CVISION_API void loadFromImage(const sf::Image& img);
         CVISION_API void getTextureImage(sf::Image& output) const;
 
+        inline sf::Image& getImage(){ return canvas; }
+        inline const sf::Image& getImage() const{ return canvas; }
+
+        CVISION_API void reset(const sf::Vector2u& size, const sf::Color& background);
+
+        CVISION_API void markDirty(const sf::IntRect& region);
+        CVISION_API void markDirty(const std::vector<sf::IntRect>& regions);
+        CVISION_API void markDirty();
+        CVISION_API void flush(); // Upload the dirty regions
+
         CVISION_API sf::Vector2u getImageSize() const;
 
         inline const bool& isVisible() const{ return bVisible; }
@@ -178,7 +227,8 @@ protected:
     sf::Text brushCoords;
 
     sf::Color fg_color,
-            bg_color;
+            bg_color,
+            stroke_color; // Latched when a stroke starts
 
     std::vector<sf::Color> palette,
                             last_colors;
@@ -191,7 +241,8 @@ protected:
     CVButtonPanel* toolset;
 
     bool bCanDraw,
-        bBrushCoords;
+        bBrushCoords,
+        bStroking;
 
 public:
 
@@ -217,6 +268,12 @@ public:
     CVISION_API void draw_to_layer(const std::string& tag,
                        std::vector<std::vector<int>> coords);
 
+    CVISION_API void stroke_layer(const unsigned int& layer_index,
+                      const sf::Vector2f& from,
+                      const sf::Vector2f& to,
+                      const sf::Color& color,
+                      const bool& continued = false);
+
     template<class... Args>
     void add_brush(Args&&... args){
         brushes.emplace_back(std::forward<Args>(args)...);
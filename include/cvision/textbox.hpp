@@ -152,6 +152,7 @@ public:
               const float& borderWidth = 0.0f);
 
     CVISION_API bool draw(sf::RenderTarget* target);
+    CVISION_API bool drawsBatched() const override;
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
 
     CVISION_API sf::FloatRect getTextBounds() const noexcept;
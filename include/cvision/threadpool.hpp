@@ -0,0 +1,134 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#pragma once
+
+#ifndef CVIS_THREADPOOL
+#define CVIS_THREADPOOL
+
+#include "cvision/lib.hpp"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace cvis
+{
+
+/** @brief Work-stealing thread pool
+  *
+  * Each worker owns a task queue.  Workers take tasks from the back of
+  * their own queue and steal from the front of other queues when idle.
+  *
+  * parallelFor() queues runners that claim indices of its batch, and the
+  * calling thread claims indices alongside them, then sleeps until the
+  * last claimed index finishes.  The caller never runs another batch's
+  * work, so a long batch (ie. asset decoding) cannot stall a caller that
+  * shares the pool, and a batch can be submitted from inside another
+  * task without deadlocking the pool.
+  */
+
+class CVISION_API CVThreadPool
+{
+public:
+
+    CVISION_API CVThreadPool(const unsigned int& threadCount = 0); // 0: one worker per hardware thread, less the caller
+    CVISION_API ~CVThreadPool();
+
+    /** @brief Run task(0) ... task(count - 1) on the pool and block until all have finished
+      *
+      * The first exception thrown by a task is rethrown once the batch is complete.
+      */
+    CVISION_API void parallelFor(const size_t& count, const std::function<void(const size_t&)>& task);
+
+    inline size_t size() const noexcept{ return workers.size(); }
+
+protected:
+
+    struct TaskQueue
+    {
+        std::mutex                          lock;
+        std::deque<std::function<void()>>   tasks;
+    };
+
+    struct Batch
+    {
+        const std::function<void(const size_t&)>*   task;       // Only called for claimed indices, while the caller waits
+        size_t                                      count;
+        std::atomic<size_t>                         next;       // Next index to claim
+        std::atomic<size_t>                         remaining;  // Indices not yet finished
+
+        std::mutex                                  lock;
+        std::condition_variable                     done;
+        std::exception_ptr                          error;
+    };
+
+    std::vector<std::thread>                workers;
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+
+    std::atomic<bool>                       bStop;
+    std::atomic<size_t>                     queuedTasks;
+    std::atomic<size_t>                     nextQueue;
+
+    std::mutex                              sleepLock;
+    std::condition_variable                 sleepSignal;
+
+    CVISION_API void push(std::function<void()> task);
+    CVISION_API bool pop(const size_t& queueIndex, std::function<void()>& task);      // Own queue first, then steal
+    CVISION_API void workerLoop(const size_t& queueIndex);
+    CVISION_API void runBatch(Batch& batch);                                         // Claim and run indices until none are left
+
+    CVThreadPool(const CVThreadPool& other) = delete;
+    CVThreadPool& operator=(const CVThreadPool& other) = delete;
+
+};
+
+}
+
+#endif // CVIS_THREADPOOL
@@ -312,6 +312,7 @@ public:
     }
 
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
+    CVISION_API bool needsUpdate() const override;
     CVISION_API bool draw(sf::RenderTarget* target);
 
 protected:
@@ -379,6 +380,7 @@ public:
     CVISION_API ~CVTypeBox();
 
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
+    CVISION_API bool needsUpdate() const override;
     CVISION_API bool draw(sf::RenderTarget* target);
 
     CVISION_API void setSize(const sf::Vector2f& newSize);
@@ -50,8 +50,13 @@
 
 #include <vector>
 #include <string>
+#include <set>
+#include <unordered_map>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
 
 #if defined WIN32 || defined _WIN32 || defined __WIN32
 #include <windows.h>
@@ -62,6 +67,11 @@
 #include "cvision/event.hpp"
 #include "cvision/anim.hpp"
 #include "cvision/algorithm.hpp"
+#include "cvision/profiler.hpp"
+#include "cvision/input.hpp"
+#include "cvision/batch.hpp"
+#include "cvision/shadow.hpp"
+#include "cvision/import.hpp"
 
 // Automatic view positioning =====================
 
@@ -197,6 +207,41 @@ protected:
     bool                        bShadow;                   // Draw the shadow texture (usually bound to the cursor)
     bool                        bMaximized;                // Is the window currently in a maximized state?
     bool                        bMinimized;                // Is the window currently in a minimized state?
+    bool                        bDirtyTracking;            // Skip the draw cycle on frames where nothing was invalidated
+    bool                        bEventDriven;              // Block the view thread while idle instead of ticking at the frame rate
+    bool                        bHeldEvent;                // An OS event was received while idle and awaits handling
+    bool                        bPipelined;                // Present frames from a separate render thread
+    bool                        bFrameReady;               // A completed frame buffer is waiting to be presented
+    bool                        bPresenting;               // Is the render thread running?
+    bool                        bParallelUpdate;           // Update independent panels on the app thread pool
+    bool                        bScheduled;                // Driven by the app view scheduler instead of init()
+    bool                        bLastFrameDirty;           // Was the last frame drawn?
+
+    std::atomic<bool>           bDirty;                    // Has anything visible changed since the last draw?
+    std::atomic<bool>           bIdle;                     // Is the view thread currently blocked waiting for activity?
+    std::atomic<bool>           bWakeRequested;            // Has another thread requested a frame?
+
+    std::mutex                  wakeLock;
+    std::condition_variable     wakeSignal;
+
+    std::chrono::high_resolution_clock::time_point wakeDeadline;   // Earliest scheduled frame while idle
+
+    sf::Event                   heldEvent;          // OS event that woke an idle view thread
+
+    std::chrono::high_resolution_clock::time_point frameStart;      // Start of the current frame
+    std::chrono::high_resolution_clock::time_point nextFrameTime;   // Deadline of the next frame (app scheduler)
+
+    std::thread*                renderThread;       // Presents completed frames in pipelined mode
+    std::mutex                  frameLock;
+    std::condition_variable     frameSignal;
+
+    CVFrameRecorder             frameRecorder;      // Stands in for the window while a frame is recorded
+    CVDrawList                  frameLists[2];      // Double-buffered recorded frames (pipelined mode)
+    bool                        frameRecorded[2];   // Was each frame recorded, or rasterised into its frame buffer?
+    sf::RenderTexture           frameBuffers[2];    // Rasterised frames, for frames that drew outside the batch
+    sf::FloatRect               frameRects[2];      // Window area covered by each frame buffer, in view coordinates
+    unsigned int                frontBuffer;        // Most recently completed frame
+    size_t                      recordRetryFrame;   // Frame index from which to try recording again
 
     float defaultViewScale;                         // Allow scaling based on view dimensions
 
@@ -221,9 +266,14 @@ protected:
     std::vector<CVViewPanel*>   waitingViewPanels;
     std::vector<std::string>    panelTags;
 
+    std::unordered_map<std::string, std::vector<CVElement*>> elementIndex;  // Attached elements by tag, in registration order
+    std::set<std::string>       indexedTags;        // Ordered tag keys of the element index for prefix lookups
+    std::mutex                  elementIndexLock;   // Elements may be added from parallel panel updates
+
     std::vector<CVElement*>     splashElements;
 
     std::vector<CVAnim>         pendingAnims;
+    std::mutex                  animLock;           // Anims may be queued from parallel panel updates
     unsigned int                numPendingAnims;
 
     CVView*                     parentView;
@@ -231,12 +281,22 @@ protected:
 
     unsigned int                frameRateLimit;
 
+    size_t                      frameIndex;         // Number of frames processed since init
+    size_t                      skippedFrames;      // Number of frames where the draw cycle was skipped (dirty tracking)
+    size_t                      inputDrainFrame;    // Frame in which OS events were last moved to the input queue
+
     float                       frameRate;
     float                       width;
     float                       height;
     float                       titleBarHeight;
     float                       viewHeight;
 
+    float                       physicsStep;            // Fixed simulation time step (s)
+    float                       physicsAccumulator;     // Frame time not yet simulated
+    float                       physicsAlpha;           // Fraction of a step by which to interpolate drawn positions
+    unsigned int                physicsSteps;           // Simulation steps to run this frame
+    unsigned int                maxPhysicsSteps;        // Cap on steps per frame, bounding the cost of a slow frame
+
     sf::Vector2i                resizeTarget;
     sf::Vector2i                resizeSpeed;
     sf::Vector2i                moveTarget;
@@ -256,11 +316,41 @@ protected:
     CVISION_API void handleTriggerEvent(const unsigned char& eventID);
     CVISION_API void activateWindow();
 
+    CVISION_API virtual bool pollViewEvent(sf::Event& event);       // Retrieve the next OS event, including one held from an idle wait
+    CVISION_API virtual bool hasViewFocus() const;                  // Does the view currently receive keyboard input?
+    CVISION_API virtual sf::Vector2f getGlobalMousePosition() const;    // Mouse position in desktop coordinates
+    CVISION_API bool idle() const;                          // Is nothing animating, moving or waiting to be drawn?
+    CVISION_API void waitForActivity();                     // Block until an OS event, a wake request or a scheduled frame
+
+    CVISION_API bool pollWindowEvent(sf::Event& event);     // Poll the window, synchronized with the render thread
+    CVISION_API bool replayInputFrame();                    // Apply the next replayed frame's input; false when not replaying
+
+    CVISION_API bool open();                                // Create the window and enter the main state
+    CVISION_API bool frame();                               // Run a single update/draw cycle; false when the view should close
+    CVISION_API void finish();                              // Close the window after the last frame
+    CVISION_API void resumeFrameClock();                    // Count an idle period as a single frame
+    CVISION_API bool awaitingActivity();                    // Non-blocking idle check for event-driven scheduled views
+    CVISION_API void startRenderThread();
+    CVISION_API void stopRenderThread();
+    CVISION_API void submitFrame();                         // Record the back frame and hand it to the render thread
+    CVISION_API void renderLoop();
+
+    CVISION_API void updateParallel(std::vector<CVElement*>& batch, CVEvent& event,   // Update a run of non-claiming panels concurrently
+                                    const sf::Vector2f& mousePos, CVElement* container);
+
+    CVISION_API void indexTag(const std::string& tag, CVElement* element);
+    CVISION_API void unindexTag(const std::string& tag, CVElement* element);
+
 public:
 
-    void init();
+    void init();                        // Run this view on the calling thread until it closes
 
     CVISION_API CVElement* getElementById(const std::string& name); // Retrieve an element by its tag
+    CVISION_API std::vector<CVElement*> getElementsByTag(const std::string& tag);
+    CVISION_API std::vector<CVElement*> getElementsByTagPrefix(const std::string& prefix);
+
+    CVISION_API void indexElement(CVElement* element);     // Register an element and its members in the tag index
+    CVISION_API void unindexElement(CVElement* element);   // Remove an element and its members from the tag index
 
     std::mutex          drawLock;               // Prevent actions during window draw
     std::mutex          updateLock;             // Prevent actions during update
@@ -269,9 +359,14 @@ public:
     sf::RenderWindow*   viewPort;
     sf::RenderTexture   textureBuffer;          // For capture of the current draw state (screenshot) or for masking/clipping, etc.
 
+    CVProfiler          profiler;               // Per-frame update/draw timings (disabled by default)
+    CVInputQueue        inputQueue;             // Timestamped OS input with record/replay
+    CVRenderBatch       renderBatch;            // Draw-call batching for panels drawn with setBatchedDraw()
+    CVShadowCache       shadowCache;            // Drop shadows shared by elements of the same outline
+
     inline bool captureRenderContext()
     {
-        if(viewPort && viewPort->isOpen())
+        if(viewPort && viewPort->isOpen() && !bPresenting)  // The render thread owns the window context while pipelined
         {
             return viewPort->setActive(true);
         }
@@ -288,6 +383,7 @@ public:
 
     CVISION_API const sf::Font* appFont(const std::string& font) const;
     CVISION_API const sf::Texture* appTexture(const std::string& tag) const;
+    CVISION_API CVTextureRegion appTextureRegion(const std::string& tag) const;
     CVISION_API const sf::Image* appImage(const std::string& tag) const;
     CVISION_API const sf::Color& appColor(const std::string& tag) const;
 
@@ -299,7 +395,7 @@ public:
     CVISION_API void setTopMargin(const float& margin);
     CVISION_API void setDropable(const bool& status = true);
 
-    inline void requestFocus(){ viewPort->requestFocus(); }
+    inline void requestFocus(){ if(viewPort) viewPort->requestFocus(); }
     inline void setBackgroundColor(const sf::Color& newColor){ backgroundColor = newColor; }
 
     inline const std::thread* mainAppThreadID() const noexcept{ return appThread; }
@@ -311,7 +407,64 @@ public:
     inline const bool& isMaximized() const noexcept{ return bMaximized; }
     inline const bool& isMinimized() const noexcept{ return bMinimized; }
 
-    inline bool window_open() const{ return viewPort && viewPort->isOpen(); }
+    inline virtual bool window_open() const{ return viewPort && viewPort->isOpen(); }
+
+    // Retained-mode dirty tracking
+
+    inline void invalidate() noexcept                                       // Request a redraw on the next frame (thread-safe)
+    {
+        bDirty = true;
+        if(bIdle) wake();
+    }
+    inline bool isDirty() const noexcept{ return bDirty; }
+
+    CVISION_API void setDirtyTracking(const bool& state = true);            // Only redraw when an element has been invalidated
+    inline const bool& dirtyTracking() const noexcept{ return bDirtyTracking; }
+
+    CVISION_API void setFrameRateLimit(const unsigned int& limit);          // 0 for unlimited
+    inline const unsigned int& getFrameRateLimit() const noexcept{ return frameRateLimit; }
+
+    inline const size_t& getFrameIndex() const noexcept{ return frameIndex; }
+
+    // Fixed-step simulation clock (element motion, bounce and friction)
+
+    CVISION_API void setPhysicsRate(const float& stepsPerSecond);               // May be lower than the frame rate
+    inline void setMaxPhysicsSteps(const unsigned int& steps) noexcept{ maxPhysicsSteps = steps ? steps : 1; }
+    inline const float& getPhysicsStep() const noexcept{ return physicsStep; }
+    inline const unsigned int& getPhysicsSteps() const noexcept{ return physicsSteps; }
+    inline const float& getPhysicsAlpha() const noexcept{ return physicsAlpha; }
+    inline const size_t& getSkippedFrameCount() const noexcept{ return skippedFrames; }
+
+    // Event-driven scheduling
+
+    CVISION_API void setEventDriven(const bool& state = true);      // Sleep on OS events while nothing is animating
+    inline const bool& eventDriven() const noexcept{ return bEventDriven; }
+
+    CVISION_API void wake();                                        // Run at least one update cycle as soon as possible (thread-safe)
+    CVISION_API void scheduleFrame(const float& delay);             // Wake an idle view after [delay] seconds (ie. cursor blink)
+
+    // Pipelined rendering
+
+    CVISION_API void setPipelined(const bool& state = true);        // Overlap the next update with presentation of the last frame
+    inline const bool& pipelined() const noexcept{ return bPipelined; }
+
+    // Parallel panel update
+
+    CVISION_API void setParallelUpdate(const bool& state = true);   // Update independent sibling panels concurrently
+    inline const bool& parallelUpdate() const noexcept{ return bParallelUpdate; }
+
+    /** @brief Update a run of independent panels and merge their event changes
+      *
+      * [batch] is given in serial update order and is cleared on return.
+      * Panels which may claim the mouse or focus this frame (under the
+      * pointer or press position, or holding a capture) are updated in order
+      * on the calling thread, so later siblings see their claims as they
+      * would serially.  The runs between them are updated on the app thread
+      * pool against copies of [event], which are merged back in order.
+      * [container] is the panel which owns the batch (nullptr at view level).
+      */
+    CVISION_API void updateIndependent(std::vector<CVElement*>& batch, CVEvent& event,
+                                       const sf::Vector2f& mousePos, CVElement* container = nullptr);
 
     inline void setElasticSelectState(bool newState) noexcept{ bElasticSelect = newState; }
     inline bool canElasticSelect() const noexcept{ return bElasticSelect; }
@@ -391,6 +544,7 @@ public:
 
     inline void animate(sf::Transformable* object, const std::vector<CVAnimCheckpoint>& checkpoints)
     {
+        std::lock_guard<std::mutex> lock(animLock);
         pendingAnims.emplace_back(object, checkpoints);
         ++numPendingAnims;
     }
@@ -399,6 +553,8 @@ public:
                         bool resetPath = true)
     {
 
+        std::lock_guard<std::mutex> lock(animLock);
+
         unsigned int index = 0;
         for(auto& anim : pendingAnims)
         {
@@ -421,6 +577,7 @@ public:
                           const float& speed, const uint8_t animType = CV_OBJ_ANIM_SLIDE,
                           bool cumulative = true)
     {
+        std::lock_guard<std::mutex> lock(animLock);
         for(auto& anim : pendingAnims)
         {
             if(anim.object() == object)
@@ -443,6 +600,7 @@ public:
 
     inline void anim_passive(sf::Transformable* object, const float& rate, const uint8_t animType = CV_OBJ_ANIM_FADE_OUT)
     {
+        std::lock_guard<std::mutex> lock(animLock);
         for(auto& anim : pendingAnims)
         {
             if(anim.object() == object)
@@ -461,6 +619,7 @@ public:
     }
     inline void resetPassiveAnim(sf::Transformable* object)
     {
+        std::lock_guard<std::mutex> lock(animLock);
         for(auto& anim : pendingAnims)
         {
             if(anim.object() == object)
@@ -496,16 +655,16 @@ public:
 
     inline void setSize(const sf::Vector2u& newSize)
     {
-        viewPort->setSize(newSize);
+        if(viewPort) viewPort->setSize(newSize);
     }
     inline void setSize(const sf::Vector2f& newSize)
     {
-        viewPort->setSize(sf::Vector2u(newSize));
+        if(viewPort) viewPort->setSize(sf::Vector2u(newSize));
     }
 
     template<typename T> void setSize(const T& width, const T& height)
     {
-        viewPort->setSize(sf::Vector2u(width, height));
+        if(viewPort) viewPort->setSize(sf::Vector2u(width, height));
     }
 
     template<typename T1, typename T2> void resize_to(const T1& width, const T1& height, const sf::Vector2<T2>& speed = sf::Vector2<T2>(1,1))
@@ -616,7 +775,8 @@ public:
 
     inline sf::Vector2i getPosition() const
     {
-        return viewPort->getPosition();
+        if(viewPort) return viewPort->getPosition();
+        return sf::Vector2i(0, 0);
     }
 
     CVISION_API void close();
@@ -643,8 +803,9 @@ public:
                                             clip_bounds.height += 2*panel.front().getOutlineThickness();\
                                             clip_region = sf::View(clip_bounds);\
                                             init_view = target->getView();\
-                                            clip_region.setViewport(sf::FloatRect(clip_bounds.left / View->renderWidth(), \
-                                                                                  clip_bounds.top / View->renderHeight(),\
+                                            sf::Vector2i clip_origin = target->mapCoordsToPixel(sf::Vector2f(clip_bounds.left, clip_bounds.top));\
+                                            clip_region.setViewport(sf::FloatRect(clip_origin.x / View->renderWidth(), \
+                                                                                  clip_origin.y / View->renderHeight(),\
                                                                     clip_bounds.width / View->renderWidth(), \
                                                                         clip_bounds.height / View->renderHeight()));\
                                             target->setView(clip_region);\
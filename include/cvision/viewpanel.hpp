@@ -49,6 +49,7 @@
 #include <SFML/Graphics.hpp>
 
 #include "cvision/textbox.hpp"
+#include "cvision/spatial.hpp"
 
 namespace cvis
 {
@@ -86,7 +87,7 @@ public:
     virtual void removePanelElement(const std::string& tag);
     virtual void removePanelElement(const unsigned int& index);
 
-    virtual void detachPanelElement(const CVElement* element) noexcept;
+    virtual void detachPanelElement(const CVElement* element);
 
     virtual void clear();
 
@@ -111,6 +112,88 @@ public:
         bOutOfBoundsDraw = state;
     }
 
+    /** @brief Allow this panel to be updated concurrently with its independent siblings
+      *
+      * Only takes effect while the view is in parallel update mode.  An
+      * independent panel must confine its update to its own elements and
+      * the CVEvent passed to it; claims made on the event (mouse, focus,
+      * keys, captured shapes) are merged back in serial update order.
+      */
+    inline void setIndependentUpdate(const bool& state = true)
+    {
+        bIndependentUpdate = state;
+    }
+    inline const bool& independentUpdate() const noexcept{ return bIndependentUpdate; }
+
+    static inline bool updatesIndependently(CVElement* element)
+    {
+        const CVViewPanel* childPanel = dynamic_cast<const CVViewPanel*>(element);
+        return childPanel && childPanel->bIndependentUpdate;
+    }
+
+    /** @brief Route hover, click and drag through a uniform grid over this panel's elements
+      *
+      * Every member is still updated each frame unless it opts in with
+      * setSkipWhenIdle().  Opted-in members are skipped while they are not
+      * under the mouse or last press position, not captured by the mouse,
+      * and report no needsUpdate().  Only opt in elements that do nothing
+      * in update() on their own clock, or that override needsUpdate() to
+      * report it, as CVProgressBar, CVPlot, CVTypeBox, CVTextLog and all
+      * view panels do.  A cellSize of zero is chosen from the view scale.
+      */
+    CVISION_API void setSpatialIndex(const bool& state = true, const float& cellSize = 0.0f);
+    inline bool spatialIndex() const noexcept{ return hitGrid != nullptr; }
+
+    inline void markMoved(CVElement* element)
+    {
+        if(hitGrid) hitGrid->markMoved(element);
+    }
+
+    CVISION_API CVElement* elementAt(const sf::Vector2f& position); // Topmost member under a point
+
+    /** @brief Position members relative to this panel
+      *
+      * Members are kept in a local space offset by getContentOffset().
+      * Moving the panel or calling moveContent() then shifts the offset
+      * instead of every descendant.  The offset is composed into the
+      * target's view when members are drawn, and into the mouse positions
+      * they receive on update.  Members also keep their offsets when the
+      * panel is resized.  Compare member bounds with this panel's through
+      * contentBounds(), or with the view through getViewBounds().
+      *
+      * Only panels that draw and update their members through
+      * CVBasicViewPanel support it (see supportsRelativeLayout()); the
+      * request is refused with a warning on any other panel.
+      */
+    CVISION_API void setRelativeLayout(const bool& state = true);
+    CVISION_API virtual bool supportsRelativeLayout() const;   // Compares the exact dynamic type, as drawsBatched() does
+    inline const bool& relativeLayout() const noexcept{ return bRelativeLayout; }
+    inline const sf::Vector2f& getContentOffset() const noexcept{ return contentOffset; }
+
+    CVISION_API void moveContent(const sf::Vector2f& distance);   // Translate all members within the panel
+
+    inline sf::FloatRect contentBounds(const CVElement* element) const    // Member bounds in the panel's space
+    {
+        sf::FloatRect output = element->getBounds();
+        output.left += contentOffset.x;
+        output.top += contentOffset.y;
+        return output;
+    }
+
+    CVISION_API bool needsUpdate() const override;
+
+    /** @brief Collect this panel's subtree into the view's render batch when drawn
+      *
+      * Shapes, sprites and text of batch-capable members are merged into
+      * one draw call per texture where draw order allows.  See
+      * CVView::renderBatch for per-frame batch and draw-call counts.
+      */
+    inline void setBatchedDraw(const bool& state = true)
+    {
+        bBatchDraw = state;
+    }
+    inline const bool& batchedDraw() const noexcept{ return bBatchDraw; }
+
     CVISION_API void setFocus(const bool& state) override;
 
     inline unsigned int numPanels() const
@@ -175,8 +258,17 @@ protected:
     bool                        bDragAndDrop;          // Transfer focus to panel elements
     bool                        bOutOfBoundsDraw;      // Draw items outside of the panel boundary
     bool                        bOutOfBoundsUpdate;    // Update items outside of the panel boundary
+    bool                        bIndependentUpdate;    // May be updated in parallel with independent siblings
     bool                        bFadeMembersOnly;
     bool                        bReverseDrawOrder;     // Reverse the panel draw order
+    bool                        bRelativeLayout;       // Members are positioned relative to contentOffset
+    bool                        bBatchDraw;            // Collect the subtree into the view's render batch
+
+    sf::Vector2f                contentOffset;         // Translation from member space to the panel's space
+
+    CVSpatialGrid*              hitGrid;               // Hit-test index over member bounds, if enabled
+    std::vector<CVElement*>     hitElements;           // Members under the cursor this frame
+    std::unordered_map<const CVElement*, size_t> hitOrder; // Member draw order, validated on use
 
     sf::Sprite*                 dragShadow;            // If drag-and-drop, a sprite for the item shadow
 
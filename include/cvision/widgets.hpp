@@ -226,6 +226,7 @@ public:
     inline void setAnimSpeed(const float& newSpeed){ animSpeed = newSpeed; }
 
     CVISION_API bool update(CVEvent& event, const sf::Vector2f& mousePos);
+    CVISION_API bool needsUpdate() const override;
 
     CVISION_API CVProgressBar(CVView* View,
                               const sf::Vector2f& position,
@@ -43,6 +43,7 @@
 
 #include "cvision/algorithm.hpp"
 #include "cvision/element.hpp"
+#include "cvision/imageops.hpp"
 
 #include <hyper/toolkit/string.hpp>
 
@@ -641,103 +642,33 @@ sf::Vector2f internal_arc(const sf::Vector2f& origin,
 void modulate(sf::Image& image, const sf::Color& newColor)
 {
 
-    sf::Color tmp;
-    for(size_t x = 0, y, xL = image.getSize().x, yL = image.getSize().y; x < xL; ++x)
-    {
-        for(y = 0; y < yL; ++y)
-        {
-            tmp = image.getPixel(x, y);
-            tmp.r = newColor.r;
-            tmp.g = newColor.g;
-            tmp.b = newColor.b;
-            image.setPixel(x, y, tmp);
-        }
-    }
+    recolor(imageSpan(image), newColor);
 
 }
 
 void expand_canvas(sf::Image& image, const sf::Vector2i& distance, const sf::Color& background)
 {
 
-    sf::Image tmp;
-    tmp.create(image.getSize().x + distance.x,
-               image.getSize().y + distance.y);
+    const sf::Vector2u size = image.getSize();
+    const int width = int(size.x) + distance.x,
+              height = int(size.y) + distance.y;
 
-    tmp.copy(image, distance.x/2, distance.y/2, sf::IntRect(0,0,0,0), true);
+    if((width <= 0) || (height <= 0)) return;
 
-    image = tmp;
+    std::vector<uint8_t> pixels(size_t(width)*height*4);
+    expandCanvas(imageSpan(image), CVImageSpan(pixels, width, height),
+                 sf::Vector2i(distance.x/2, distance.y/2), background);
+
+    image.create(width, height, pixels.data());
 
 }
 
-void gaussianBlur(sf::Image& image, const int& radius)
+void gaussianBlur(sf::Image& image, const int& radius, CVThreadPool* pool)
 {
 
-    sf::Color tmp;
-
-    int x;
-    int y;
-    int xs;
-    int xmin;
-    int xmax;
-    int ys;
-    int ymin;
-    int ymax;
-
-    int xL = image.getSize().x;
-    int yL = image.getSize().y;
-    int rs = ceil(radius * 2.57); // Radius where integral drops to ~0
-
-    double wsum;
-    double weight;
-    double dsq;
-
-    double _2rsq = 2 * radius * radius;
-    double PI2rsq = PI * _2rsq;
-
-    double r;
-    double g;
-    double b;
-    double a;
-
-    for(x = 0; x < xL; ++x)
-    {
-        for(y = 0; y < yL; ++y)
-        {
-            r = 0;
-            g = 0;
-            b = 0;
-            a = 0;
+    if(radius < 1) return;
 
-            wsum = 0.0;
-
-            xmin = x - rs < 0 ? 0 : x - rs;
-            xmax = x + rs < xL ? x + rs : xL;
-            ymin = y - rs < 0 ? 0 : y - rs;
-            ymax = y + rs < yL ? y + rs : yL;
-
-            for(xs = xmin; xs < xmax; ++xs)
-            {
-                for(ys = ymin; ys < ymax; ++ys)
-                {
-                    tmp = image.getPixel(x, y);
-
-                    dsq = (xs - x)*(xs - x) + (ys - y)*(ys - y);
-                    weight = exp(-dsq/_2rsq)/PI2rsq;
-
-                    r += weight * tmp.r;
-                    g += weight * tmp.g;
-                    b += weight * tmp.b;
-                    a += weight * tmp.a;
-
-                    wsum += weight;
-
-                }
-            }
-
-            using std::round;
-            image.setPixel(x, y, sf::Color(round(r/wsum), round(g/wsum), round(b/wsum), round(a/wsum)));
-        }
-    }
+    gaussianBlur(imageSpan(image), radius, pool);
 
 }
 
@@ -43,6 +43,8 @@
 
 #include "cvision/app.hpp"
 #include "cvision/view.hpp"
+#include "cvision/threadpool.hpp"
+#include "cvision/loader.hpp"
 
 #if defined WIN32 || defined _WIN32 || defined __WIN32
 #include <windows.h>
@@ -77,6 +79,11 @@ void CVApp::pushEvent(const std::string& tag)
 
     unhandledEvents.emplace_back(tag);
 
+    for(auto& view : viewList)  // Idle event-driven views may be waiting on this event
+    {
+        view->wake();
+    }
+
 }
 
 void CVApp::clearEvents()
@@ -102,6 +109,89 @@ void CVApp::mainUpdate()
 
 }
 
+void CVApp::runViewScheduler()
+{
+
+    const std::chrono::milliseconds idlePollInterval(10); // Matches sf::Window::waitEvent
+
+    std::vector<CVView*> scheduledViews;
+
+    while(true)
+    {
+
+        lock();
+        for(auto& view : viewList)
+        {
+            // Unstarted views only: headless views report an open window without a viewport
+
+            if(!view->bScheduled && !view->viewPort &&
+               !view->bClosed && !view->window_open())
+            {
+                view->bScheduled = true;
+                scheduledViews.push_back(view);
+
+                if(!view->open())
+                {
+                    view->finish();
+                    scheduledViews.pop_back();
+                }
+            }
+        }
+        unlock();
+
+        if(scheduledViews.empty()) break;
+
+        // Service the view with the earliest deadline
+
+        std::vector<CVView*>::iterator next = scheduledViews.begin();
+        for(auto it = scheduledViews.begin() + 1; it != scheduledViews.end(); ++it)
+        {
+            if((*it)->nextFrameTime < (*next)->nextFrameTime) next = it;
+        }
+
+        CVView* view = *next;
+
+        if(view->nextFrameTime > TIME_NOW)
+        {
+            std::this_thread::sleep_until(view->nextFrameTime);
+        }
+
+        if(view->awaitingActivity())
+        {
+            view->nextFrameTime = TIME_NOW + idlePollInterval;
+            continue;
+        }
+
+        if(!view->frame())
+        {
+            view->finish();
+            scheduledViews.erase(next);
+            continue;
+        }
+
+        if(view->frameRateLimit)
+        {
+            // Keep to the view's own frame rate without bursting to catch up
+
+            view->nextFrameTime += std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+                                        std::chrono::duration<float>(1.0f/view->frameRateLimit));
+            if(view->nextFrameTime < TIME_NOW) view->nextFrameTime = TIME_NOW;
+        }
+        else
+        {
+            view->nextFrameTime = TIME_NOW;
+        }
+
+    }
+
+}
+
+std::thread* CVApp::launchViewScheduler()
+{
+    viewThreads.push_back(new std::thread(&CVApp::runViewScheduler, this));
+    return viewThreads.back();
+}
+
 void CVApp::closeView(const unsigned int viewIndex)
 {
     viewList[viewIndex]->close();
@@ -148,6 +238,8 @@ CVApp::CVApp(unsigned int frameRate,
                     running(false),
                     mainUpdateThread(nullptr),
                     defaultFont(defaultFont),
+                    taskPool(nullptr),
+                    assetLoad(nullptr),
                     frameRate(frameRate),
                     frameTime(1.0f/frameRate),
                     leftClickLatency(leftClickLatency),
@@ -165,6 +257,27 @@ CVApp::~CVApp()
     running = false;
     closeAll();
     if(mainUpdateThread) mainUpdateThread->join();
+    if(assetLoad) delete(assetLoad);
+    if(taskPool) delete(taskPool);
+}
+
+CVThreadPool& CVApp::threadPool()
+{
+    std::lock_guard<std::mutex> lock(taskPoolLock);
+    if(!taskPool)
+    {
+        taskPool = new CVThreadPool();
+    }
+    return *taskPool;
+}
+
+CVAssetLoader& CVApp::assetLoader()
+{
+    if(!assetLoad)
+    {
+        assetLoad = new CVAssetLoader(this);
+    }
+    return *assetLoad;
 }
 
 bool CVApp::addView(CVView* View, const std::string& viewTag)
@@ -0,0 +1,586 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/assetpack.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#if defined WIN32 || defined _WIN32 || defined __WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+namespace cvis
+{
+
+static const size_t packAlignment = 16;
+static const uint32_t packMaxExtent = 65536;    // Beyond any texture size limit; keeps level sizes well inside 64 bits
+
+inline static uint64_t packLevelBytes(const CVPackPage& page, const unsigned int& level)
+{
+    return uint64_t(max(1u, page.width >> level))*max(1u, page.height >> level)*4;
+}
+
+// Length of the full mip chain, down to 1 x 1
+
+inline static unsigned int packChainLength(const CVPackPage& page)
+{
+    unsigned int levels = 1;
+    unsigned int extent = max(page.width, page.height);
+    while(extent >>= 1) ++levels;
+    return levels;
+}
+
+CVAssetPack::CVAssetPack():
+    data(nullptr),
+    size(0),
+#if defined WIN32 || defined _WIN32 || defined __WIN32
+    fileHandle(nullptr),
+    mapHandle(nullptr),
+#endif
+    strings(nullptr),
+    stringSize(0)
+{
+
+}
+
+CVAssetPack::~CVAssetPack()
+{
+    close();
+}
+
+bool CVAssetPack::open(const string& fileName)
+{
+    close();
+
+#if defined WIN32 || defined _WIN32 || defined __WIN32
+
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || !fileSize.QuadPart)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mapHandle = mapping;
+    data = (const uint8_t*)view;
+    size = fileSize.QuadPart;
+
+#else
+
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if(file < 0) return false;
+
+    struct stat fileStat;
+    if((fstat(file, &fileStat) != 0) || !fileStat.st_size)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* view = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);  // The mapping keeps the file alive
+
+    if(view == MAP_FAILED) return false;
+
+    data = (const uint8_t*)view;
+    size = fileStat.st_size;
+
+#endif
+
+    if(!validate())
+    {
+        cout << "Warning (CVision): \"" << fileName << "\" is not a valid asset pack\n";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void CVAssetPack::close()
+{
+    if(data)
+    {
+#if defined WIN32 || defined _WIN32 || defined __WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mapHandle);
+        CloseHandle(fileHandle);
+        mapHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap((void*)data, size);
+#endif
+    }
+
+    data = nullptr;
+    size = 0;
+    strings = nullptr;
+    stringSize = 0;
+
+    pages.clear();
+    images.clear();
+    fonts.clear();
+}
+
+bool CVAssetPack::validate()
+{
+    if(size < sizeof(CVPackHeader)) return false;
+
+    CVPackHeader header;
+    memcpy(&header, data, sizeof(CVPackHeader));
+
+    if(memcmp(header.magic, "CVPK", 4) || (header.version != CV_PACK_VERSION)) return false;
+
+    // Copy the tables out, since the mapping gives no alignment guarantees
+
+    uint64_t offset = sizeof(CVPackHeader);
+    const uint64_t tableSize = uint64_t(header.numPages)*sizeof(CVPackPage) +
+                               uint64_t(header.numImages)*sizeof(CVPackImage) +
+                               uint64_t(header.numFonts)*sizeof(CVPackFont);
+
+    if(offset + tableSize + header.stringSize > size) return false;
+
+    pages.resize(header.numPages);
+    images.resize(header.numImages);
+    fonts.resize(header.numFonts);
+
+    if(header.numPages) memcpy(pages.data(), data + offset, header.numPages*sizeof(CVPackPage));
+    offset += header.numPages*sizeof(CVPackPage);
+    if(header.numImages) memcpy(images.data(), data + offset, header.numImages*sizeof(CVPackImage));
+    offset += header.numImages*sizeof(CVPackImage);
+    if(header.numFonts) memcpy(fonts.data(), data + offset, header.numFonts*sizeof(CVPackFont));
+    offset += header.numFonts*sizeof(CVPackFont);
+
+    strings = (const char*)(data + offset);
+    stringSize = header.stringSize;
+
+    for(auto& page : pages)
+    {
+        if(!page.width || !page.height ||
+           (page.width > packMaxExtent) || (page.height > packMaxExtent) ||
+           !page.levels || (page.levels > packChainLength(page))) return false;
+
+        uint64_t pageBytes = 0;
+        for(unsigned int i = 0; i < page.levels; ++i)
+        {
+            const uint64_t levelBytes = packLevelBytes(page, i);
+            if(levelBytes > UINT64_MAX - pageBytes) return false;
+            pageBytes += levelBytes;
+        }
+
+        if((page.offset > size) || (pageBytes > size - page.offset)) return false;
+    }
+
+    for(auto& image : images)
+    {
+        if((uint64_t(image.tagOffset) + image.tagSize > stringSize) ||
+           (image.page >= pages.size())) return false;
+
+        const CVPackPage& page = pages[image.page];
+        if((image.left < 0) || (image.top < 0) ||
+           (image.width <= 0) || (image.height <= 0) ||
+           (uint64_t(image.left) + image.width > page.width) ||
+           (uint64_t(image.top) + image.height > page.height)) return false;
+    }
+
+    for(auto& font : fonts)
+    {
+        if((uint64_t(font.tagOffset) + font.tagSize > stringSize) ||
+           (font.offset > size) || (font.size > size - font.offset)) return false;
+    }
+
+    return true;
+}
+
+const uint8_t* CVAssetPack::pagePixels(const size_t& index,
+                                       const unsigned int& level) const
+{
+    const CVPackPage& page = pages[index];
+    if(level >= page.levels) return nullptr;
+
+    uint64_t offset = page.offset;
+    for(unsigned int i = 0; i < level; ++i)
+    {
+        offset += packLevelBytes(page, i);
+    }
+
+    return data + offset;
+}
+
+sf::Vector2u CVAssetPack::pageLevelSize(const size_t& index,
+                                        const unsigned int& level) const
+{
+    const CVPackPage& page = pages[index];
+    return sf::Vector2u(max(1u, page.width >> level), max(1u, page.height >> level));
+}
+
+string CVAssetPack::imageTag(const size_t& index) const
+{
+    return string(strings + images[index].tagOffset, images[index].tagSize);
+}
+
+string CVAssetPack::fontTag(const size_t& index) const
+{
+    return string(strings + fonts[index].tagOffset, fonts[index].tagSize);
+}
+
+CVAssetPackWriter::CVAssetPackWriter():
+    bAtlas(false),
+    bMipmaps(false),
+    atlasPageSize(2048),
+    atlasMaxItemSize(256)
+{
+
+}
+
+bool CVAssetPackWriter::addImage(const sf::Image& image, const string& tag)
+{
+    if(!image.getSize().x || !image.getSize().y) return false;
+
+    imageEntries.emplace_back();
+    imageEntries.back().tag = tag;
+    imageEntries.back().image = image;
+    return true;
+}
+
+bool CVAssetPackWriter::addImage(const string& fileName, const string& tag)
+{
+    sf::Image image;
+    if(!image.loadFromFile(fileName))
+    {
+        cout << "Failed to load image: " << fileName << '\n';
+        return false;
+    }
+    return addImage(image, tag);
+}
+
+bool CVAssetPackWriter::addImage(const void* binaries, const size_t& size,
+                                 const string& tag)
+{
+    sf::Image image;
+    if(!image.loadFromMemory(binaries, size))
+    {
+        cout << "Failed to load image: " << tag << '\n';
+        return false;
+    }
+    return addImage(image, tag);
+}
+
+bool CVAssetPackWriter::addFont(const string& fileName, const string& tag)
+{
+    ifstream input(fileName, ios::binary);
+    if(!input.good())
+    {
+        cout << "Failed to load font from: " << fileName << '\n';
+        return false;
+    }
+
+    vector<uint8_t> bytes((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+    return addFont(bytes.data(), bytes.size(), tag);
+}
+
+bool CVAssetPackWriter::addFont(const void* binaries, const size_t& size,
+                                const string& tag)
+{
+    if(!binaries || !size) return false;
+
+    fontEntries.emplace_back();
+    fontEntries.back().tag = tag;
+    fontEntries.back().bytes.assign((const uint8_t*)binaries, (const uint8_t*)binaries + size);
+    return true;
+}
+
+void CVAssetPackWriter::setAtlasMode(const bool& state,
+                                     const unsigned int& pageSize,
+                                     const unsigned int& maxItemSize)
+{
+    bAtlas = state;
+    atlasPageSize = pageSize;
+    atlasMaxItemSize = maxItemSize < pageSize ? maxItemSize : pageSize;
+}
+
+// Halve an RGBA level with a 2x2 box filter, weighting colour by alpha
+// so that transparent texels do not darken the edges of icons
+
+static void packDownsample(const vector<uint8_t>& source,
+                           const sf::Vector2u& sourceSize,
+                           vector<uint8_t>& output,
+                           const sf::Vector2u& outputSize)
+{
+    output.resize(size_t(outputSize.x)*outputSize.y*4);
+
+    for(unsigned int y = 0; y < outputSize.y; ++y)
+    {
+        const unsigned int y0 = min(2*y, sourceSize.y - 1),
+                           y1 = min(2*y + 1, sourceSize.y - 1);
+
+        for(unsigned int x = 0; x < outputSize.x; ++x)
+        {
+            const unsigned int x0 = min(2*x, sourceSize.x - 1),
+                               x1 = min(2*x + 1, sourceSize.x - 1);
+
+            const uint8_t* texels[4] = { &source[(size_t(y0)*sourceSize.x + x0)*4],
+                                         &source[(size_t(y0)*sourceSize.x + x1)*4],
+                                         &source[(size_t(y1)*sourceSize.x + x0)*4],
+                                         &source[(size_t(y1)*sourceSize.x + x1)*4] };
+
+            unsigned int alpha = 0, color[3] = { 0, 0, 0 };
+            for(auto& texel : texels)
+            {
+                alpha += texel[3];
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    color[c] += texel[c]*texel[3];
+                }
+            }
+
+            uint8_t* out = &output[(size_t(y)*outputSize.x + x)*4];
+            for(size_t c = 0; c < 3; ++c)
+            {
+                out[c] = alpha ? (color[c] + alpha/2)/alpha : 0;
+            }
+            out[3] = (alpha + 2)/4;
+        }
+    }
+}
+
+bool CVAssetPackWriter::write(const string& fileName)
+{
+    // Lay out the pages
+
+    vector<sf::Image> pageImages;
+    vector<CVPackPage> pages;
+    vector<CVPackImage> images;
+    vector<CVPackFont> fonts;
+    string strings;
+
+    CVShelfPacker packer(atlasPageSize, CV_ATLAS_PADDING, CV_ATLAS_PADDING);
+    vector<size_t> atlasPages; // Packer page to pack page
+
+    for(auto& entry : imageEntries)
+    {
+        const sf::Vector2u size = entry.image.getSize();
+
+        CVPackImage record;
+        record.tagOffset = strings.size();
+        record.tagSize = entry.tag.size();
+        record.width = size.x;
+        record.height = size.y;
+        record.flags = 0;
+        strings += entry.tag;
+
+        unsigned int atlasPage;
+        sf::Vector2u position;
+
+        if(bAtlas &&
+           (size.x <= atlasMaxItemSize) && (size.y <= atlasMaxItemSize) &&
+           packer.insert(size, atlasPage, position))
+        {
+            while(atlasPages.size() <= atlasPage)
+            {
+                const unsigned int pageSize = packer.getPageSize(atlasPages.size());
+
+                atlasPages.push_back(pageImages.size());
+                pageImages.emplace_back();
+                pageImages.back().create(pageSize, pageSize, sf::Color::Transparent);
+                pages.push_back({ pageSize, pageSize, 1, 0, 0 });
+            }
+
+            record.page = atlasPages[atlasPage];
+            record.left = position.x;
+            record.top = position.y;
+            pageImages[record.page].copy(entry.image, position.x, position.y);
+        }
+        else
+        {
+            record.page = pageImages.size();
+            record.left = 0;
+            record.top = 0;
+            pageImages.push_back(entry.image);
+            pages.push_back({ size.x, size.y, 1, CV_PACK_PAGE_STANDALONE, 0 });
+        }
+
+        images.push_back(record);
+    }
+
+    for(auto& entry : fontEntries)
+    {
+        CVPackFont record;
+        record.tagOffset = strings.size();
+        record.tagSize = entry.tag.size();
+        record.offset = 0;
+        record.size = entry.bytes.size();
+        strings += entry.tag;
+        fonts.push_back(record);
+    }
+
+    // Assign data offsets
+
+    auto align = [](const uint64_t& offset)
+    {
+        return (offset + packAlignment - 1)/packAlignment*packAlignment;
+    };
+
+    CVPackHeader header;
+    memcpy(header.magic, "CVPK", 4);
+    header.version = CV_PACK_VERSION;
+    header.numPages = pages.size();
+    header.numImages = images.size();
+    header.numFonts = fonts.size();
+    header.stringSize = strings.size();
+
+    uint64_t offset = align(sizeof(CVPackHeader) +
+                            pages.size()*sizeof(CVPackPage) +
+                            images.size()*sizeof(CVPackImage) +
+                            fonts.size()*sizeof(CVPackFont) +
+                            strings.size());
+
+    for(auto& page : pages)
+    {
+        if(bMipmaps)
+        {
+            page.levels = packChainLength(page);
+
+            if(!(page.flags & CV_PACK_PAGE_STANDALONE) && (page.levels > CV_ATLAS_MIP_LEVELS + 1))
+            {
+                page.levels = CV_ATLAS_MIP_LEVELS + 1;  // Deeper levels would bleed across the padding
+            }
+        }
+
+        page.offset = offset;
+        for(unsigned int i = 0; i < page.levels; ++i)
+        {
+            offset += packLevelBytes(page, i);
+        }
+        offset = align(offset);
+    }
+
+    for(auto& font : fonts)
+    {
+        font.offset = offset;
+        offset = align(offset + font.size);
+    }
+
+    // Write
+
+    ofstream output(fileName, ios::binary | ios::trunc);
+    if(!output.good())
+    {
+        cout << "Warning (CVision): could not open \"" << fileName << "\" to write asset pack\n";
+        return false;
+    }
+
+    auto pad = [&output, &align]()
+    {
+        static const char zeros[packAlignment] = { 0 };
+        const uint64_t position = output.tellp();
+        output.write(zeros, align(position) - position);
+    };
+
+    output.write((const char*)&header, sizeof(CVPackHeader));
+    output.write((const char*)pages.data(), pages.size()*sizeof(CVPackPage));
+    output.write((const char*)images.data(), images.size()*sizeof(CVPackImage));
+    output.write((const char*)fonts.data(), fonts.size()*sizeof(CVPackFont));
+    output.write(strings.data(), strings.size());
+    pad();
+
+    vector<uint8_t> level, nextLevel;
+
+    for(size_t i = 0; i < pages.size(); ++i)
+    {
+        const uint8_t* pixels = pageImages[i].getPixelsPtr();
+        level.assign(pixels, pixels + packLevelBytes(pages[i], 0));
+
+        output.write((const char*)level.data(), level.size());
+
+        for(unsigned int l = 1; l < pages[i].levels; ++l)
+        {
+            packDownsample(level, sf::Vector2u(max(1u, pages[i].width >> (l - 1)), max(1u, pages[i].height >> (l - 1))),
+                           nextLevel, sf::Vector2u(max(1u, pages[i].width >> l), max(1u, pages[i].height >> l)));
+            level.swap(nextLevel);
+            output.write((const char*)level.data(), level.size());
+        }
+
+        pad();
+    }
+
+    for(size_t i = 0; i < fontEntries.size(); ++i)
+    {
+        output.write((const char*)fontEntries[i].bytes.data(), fontEntries[i].bytes.size());
+        pad();
+    }
+
+    return output.good();
+}
+
+}
@@ -0,0 +1,597 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/batch.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+namespace cvis
+{
+
+namespace
+{
+
+const unsigned int batchCellSize = 32;  // Screen cell size in pixels for draw order tracking
+
+inline sf::Vector2f unitNormal(const sf::Vector2f& p1, const sf::Vector2f& p2)
+{
+    sf::Vector2f normal(p1.y - p2.y, p2.x - p1.x);
+    float length = sqrt(normal.x*normal.x + normal.y*normal.y);
+    if(length != 0.0f)
+    {
+        normal /= length;
+    }
+    return normal;
+}
+
+inline void appendQuad(vector<sf::Vertex>& output,
+                       const sf::Vertex& topLeft,
+                       const sf::Vertex& topRight,
+                       const sf::Vertex& bottomLeft,
+                       const sf::Vertex& bottomRight)
+{
+    output.push_back(topLeft);
+    output.push_back(topRight);
+    output.push_back(bottomLeft);
+    output.push_back(bottomLeft);
+    output.push_back(topRight);
+    output.push_back(bottomRight);
+}
+
+inline bool sameView(const sf::View& first, const sf::View& second)
+{
+    return equal(first.getTransform().getMatrix(), first.getTransform().getMatrix() + 16,
+                 second.getTransform().getMatrix()) &&
+            (first.getViewport() == second.getViewport());
+}
+
+}
+
+CVDrawList::CVDrawList()
+{
+
+}
+
+void CVDrawList::clear()
+{
+    commands.clear();
+    vertices.clear();
+}
+
+void CVDrawList::add(const sf::View& view, const sf::Texture* texture,
+                     const vector<sf::Vertex>& vertices)
+{
+
+    if(vertices.empty()) return;
+
+    // Extend the last command if nothing was recorded in between
+
+    if(commands.empty() || (commands.back().texture != texture) ||
+       !sameView(commands.back().view, view))
+    {
+        commands.push_back({view, texture, this->vertices.size(), 0});
+    }
+
+    this->vertices.insert(this->vertices.end(), vertices.begin(), vertices.end());
+    commands.back().count += vertices.size();
+
+}
+
+void CVDrawList::replay(sf::RenderTarget& target) const
+{
+
+    if(commands.empty()) return;
+
+    const sf::View initView = target.getView();
+    const sf::View* currentView = &initView;
+
+    for(auto& command : commands)
+    {
+        if(!sameView(*currentView, command.view))
+        {
+            target.setView(command.view);
+            currentView = &command.view;
+        }
+
+        target.draw(vertices.data() + command.first, command.count,
+                    sf::Triangles, sf::RenderStates(command.texture));
+    }
+
+    target.setView(initView);
+
+}
+
+CVFrameRecorder::CVFrameRecorder():
+    size(0, 0),
+    bMissedDraw(false)
+{
+    initialize();
+}
+
+void CVFrameRecorder::reset(const sf::Vector2u& size, const sf::View& view)
+{
+    this->size = size;
+    bMissedDraw = false;
+
+    initialize();   // Default view for the new size
+    setView(view);
+}
+
+sf::Vector2u CVFrameRecorder::getSize() const
+{
+    return size;
+}
+
+bool CVFrameRecorder::setActive(bool active)
+{
+    if(active) bMissedDraw = true;
+    return false;   // The draw is skipped without touching OpenGL
+}
+
+CVRenderBatch::CVRenderBatch():
+    target(nullptr),
+    recordList(nullptr),
+    bCollecting(false),
+    suspendDepth(0),
+    batchCount(0),
+    gridWidth(0),
+    gridHeight(0),
+    currentStats({0, 0, 0}),
+    lastStats({0, 0, 0})
+{
+
+}
+
+bool CVRenderBatch::begin(sf::RenderTarget* target)
+{
+
+    if(!target || bCollecting || suspendDepth) return false;
+
+    this->target = target;
+    bCollecting = true;
+    batchView = target->getView();
+
+    gridWidth = (target->getSize().x + batchCellSize - 1)/batchCellSize;
+    gridHeight = (target->getSize().y + batchCellSize - 1)/batchCellSize;
+    cells.assign(gridWidth*gridHeight, -1);
+
+    return true;
+
+}
+
+bool CVRenderBatch::record(sf::RenderTarget* target, CVDrawList* list)
+{
+    if(!list || !begin(target)) return false;
+    recordList = list;
+    return true;
+}
+
+void CVRenderBatch::end()
+{
+    flush();
+    bCollecting = false;
+    target = nullptr;
+    recordList = nullptr;
+}
+
+void CVRenderBatch::flush()
+{
+
+    if(!bCollecting || !batchCount) return;
+
+    const sf::View currentView = target->getView();
+    const bool bRestoreView = !recordList && !sameView(currentView, batchView);
+
+    if(bRestoreView)
+    {
+        target->setView(batchView);
+    }
+
+    for(size_t i = 0; i < batchCount; ++i)
+    {
+        if(batches[i].vertices.empty()) continue;
+
+        if(recordList)
+        {
+            recordList->add(batchView, batches[i].texture, batches[i].vertices);
+        }
+        else
+        {
+            target->draw(batches[i].vertices.data(), batches[i].vertices.size(),
+                         sf::Triangles, sf::RenderStates(batches[i].texture));
+        }
+
+        ++currentStats.drawCalls;
+        ++currentStats.batches;
+    }
+
+    if(bRestoreView)
+    {
+        target->setView(currentView);
+    }
+
+    batchCount = 0;
+    textureBatches.clear();
+    fill(cells.begin(), cells.end(), -1);
+
+}
+
+void CVRenderBatch::suspend()
+{
+    flush();
+    ++suspendDepth;
+}
+
+void CVRenderBatch::resume()
+{
+    if(suspendDepth) --suspendDepth;
+    if(bCollecting && !suspendDepth)
+    {
+        batchView = target->getView();
+    }
+}
+
+void CVRenderBatch::beginFrame()
+{
+    lastStats = currentStats;
+    currentStats = {0, 0, 0};
+}
+
+void CVRenderBatch::syncView()
+{
+    if(!sameView(target->getView(), batchView))
+    {
+        flush();
+        batchView = target->getView();
+    }
+}
+
+void CVRenderBatch::add(const sf::Texture* texture, const vector<sf::Vertex>& vertices)
+{
+
+    if(vertices.empty()) return;
+
+    // Screen cells covered by the item
+
+    sf::Vector2f minPos = vertices.front().position,
+                 maxPos = vertices.front().position;
+
+    for(auto& vertex : vertices)
+    {
+        minPos.x = min(minPos.x, vertex.position.x);
+        minPos.y = min(minPos.y, vertex.position.y);
+        maxPos.x = max(maxPos.x, vertex.position.x);
+        maxPos.y = max(maxPos.y, vertex.position.y);
+    }
+
+    const sf::Vector2i minPixel = target->mapCoordsToPixel(minPos, batchView),
+                       maxPixel = target->mapCoordsToPixel(maxPos, batchView);
+
+    const int left = max(0, min(minPixel.x, maxPixel.x)/(int)batchCellSize),
+              top = max(0, min(minPixel.y, maxPixel.y)/(int)batchCellSize),
+              right = min((int)gridWidth - 1, max(minPixel.x, maxPixel.x)/(int)batchCellSize),
+              bottom = min((int)gridHeight - 1, max(minPixel.y, maxPixel.y)/(int)batchCellSize);
+
+    int latest = -1;
+    for(int y = top; y <= bottom; ++y)
+    {
+        for(int x = left; x <= right; ++x)
+        {
+            latest = max(latest, cells[y*gridWidth + x]);
+        }
+    }
+
+    // Join the latest batch of this texture unless a later batch overlaps
+
+    size_t index;
+    auto it = textureBatches.find(texture);
+
+    if((it != textureBatches.end()) && ((int)it->second >= latest))
+    {
+        index = it->second;
+    }
+    else
+    {
+        index = batchCount++;
+        if(index == batches.size())
+        {
+            batches.emplace_back();
+        }
+        batches[index].texture = texture;
+        batches[index].vertices.clear();
+        textureBatches[texture] = index;
+    }
+
+    batches[index].vertices.insert(batches[index].vertices.end(), vertices.begin(), vertices.end());
+
+    for(int y = top; y <= bottom; ++y)
+    {
+        for(int x = left; x <= right; ++x)
+        {
+            cells[y*gridWidth + x] = index;
+        }
+    }
+
+    ++currentStats.items;
+
+}
+
+void CVRenderBatch::draw(sf::RenderTarget* target, const sf::Shape& shape)
+{
+
+    if(!collecting(target))
+    {
+        target->draw(shape);
+        ++currentStats.drawCalls;
+        return;
+    }
+
+    syncView();
+
+    const size_t pointCount = shape.getPointCount();
+    if(pointCount < 3) return;
+
+    const sf::Transform& transform = shape.getTransform();
+
+    // Fill: a fan about the centre of the local bounds, as sf::Shape draws it
+
+    sf::Vector2f minPoint = shape.getPoint(0), maxPoint = minPoint;
+    for(size_t i = 1; i < pointCount; ++i)
+    {
+        const sf::Vector2f point = shape.getPoint(i);
+        minPoint.x = min(minPoint.x, point.x);
+        minPoint.y = min(minPoint.y, point.y);
+        maxPoint.x = max(maxPoint.x, point.x);
+        maxPoint.y = max(maxPoint.y, point.y);
+    }
+    const sf::FloatRect insideBounds(minPoint, maxPoint - minPoint);
+
+    const sf::Vector2f center(insideBounds.left + insideBounds.width/2,
+                              insideBounds.top + insideBounds.height/2);
+    const sf::IntRect& textureRect = shape.getTextureRect();
+
+    auto fillVertex = [&](const sf::Vector2f& point)
+    {
+        float xRatio = insideBounds.width > 0 ? (point.x - insideBounds.left)/insideBounds.width : 0,
+              yRatio = insideBounds.height > 0 ? (point.y - insideBounds.top)/insideBounds.height : 0;
+        return sf::Vertex(transform.transformPoint(point), shape.getFillColor(),
+                          sf::Vector2f(textureRect.left + textureRect.width*xRatio,
+                                       textureRect.top + textureRect.height*yRatio));
+    };
+
+    if(shape.getFillColor().a)
+    {
+        scratch.clear();
+        const sf::Vertex centerVertex = fillVertex(center);
+        for(size_t i = 0; i < pointCount; ++i)
+        {
+            scratch.push_back(centerVertex);
+            scratch.push_back(fillVertex(shape.getPoint(i)));
+            scratch.push_back(fillVertex(shape.getPoint((i + 1) % pointCount)));
+        }
+        add(shape.getTexture(), scratch);
+    }
+
+    // Outline: an untextured strip along the point normals, as sf::Shape draws it
+
+    const float thickness = shape.getOutlineThickness();
+    if((thickness != 0.0f) && shape.getOutlineColor().a)
+    {
+        scratch.clear();
+
+        sf::Vector2f innerPrev, outerPrev;
+        for(size_t i = 0; i <= pointCount; ++i)
+        {
+            const size_t index = i % pointCount;
+            const sf::Vector2f p0 = shape.getPoint((index + pointCount - 1) % pointCount),
+                               p1 = shape.getPoint(index),
+                               p2 = shape.getPoint((index + 1) % pointCount);
+
+            sf::Vector2f n1 = unitNormal(p0, p1),
+                         n2 = unitNormal(p1, p2);
+
+            if(n1.x*(center.x - p1.x) + n1.y*(center.y - p1.y) > 0) n1 = -n1;
+            if(n2.x*(center.x - p1.x) + n2.y*(center.y - p1.y) > 0) n2 = -n2;
+
+            const float factor = 1.0f + (n1.x*n2.x + n1.y*n2.y);
+            const sf::Vector2f normal = factor != 0.0f ? (n1 + n2)/factor : n1;
+
+            const sf::Vector2f inner = transform.transformPoint(p1),
+                               outer = transform.transformPoint(p1 + normal*thickness);
+
+            if(i > 0)
+            {
+                appendQuad(scratch,
+                           sf::Vertex(innerPrev, shape.getOutlineColor()),
+                           sf::Vertex(outerPrev, shape.getOutlineColor()),
+                           sf::Vertex(inner, shape.getOutlineColor()),
+                           sf::Vertex(outer, shape.getOutlineColor()));
+            }
+
+            innerPrev = inner;
+            outerPrev = outer;
+        }
+
+        add(nullptr, scratch);
+    }
+
+}
+
+void CVRenderBatch::draw(sf::RenderTarget* target, const sf::Sprite& sprite)
+{
+
+    if(!collecting(target) || !sprite.getTexture())
+    {
+        draw(target, (const sf::Drawable&)sprite);
+        return;
+    }
+
+    syncView();
+
+    const sf::Transform& transform = sprite.getTransform();
+    const sf::IntRect& rect = sprite.getTextureRect();
+    const sf::Color& color = sprite.getColor();
+
+    const float width = abs(rect.width),
+                height = abs(rect.height),
+                left = rect.left,
+                right = left + rect.width,
+                top = rect.top,
+                bottom = top + rect.height;
+
+    scratch.clear();
+    appendQuad(scratch,
+               sf::Vertex(transform.transformPoint(0.0f, 0.0f), color, sf::Vector2f(left, top)),
+               sf::Vertex(transform.transformPoint(width, 0.0f), color, sf::Vector2f(right, top)),
+               sf::Vertex(transform.transformPoint(0.0f, height), color, sf::Vector2f(left, bottom)),
+               sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom)));
+
+    add(sprite.getTexture(), scratch);
+
+}
+
+void CVRenderBatch::draw(sf::RenderTarget* target, const sf::Text& text)
+{
+
+    const sf::Font* font = text.getFont();
+
+    if(!collecting(target) || !font || (text.getOutlineThickness() != 0.0f) ||
+       (text.getStyle() & (sf::Text::Underlined | sf::Text::StrikeThrough)))
+    {
+        draw(target, (const sf::Drawable&)text);
+        return;
+    }
+
+    syncView();
+
+    // Glyph layout as in sf::Text
+
+    const unsigned int characterSize = text.getCharacterSize();
+    const bool bBold = text.getStyle() & sf::Text::Bold;
+    const float italicShear = (text.getStyle() & sf::Text::Italic) ? 0.209f : 0.0f;   // 12 degrees
+
+    float whitespaceWidth = font->getGlyph(L' ', characterSize, bBold).advance;
+    const float letterSpacing = (whitespaceWidth/3.0f)*(text.getLetterSpacing() - 1.0f);
+    whitespaceWidth += letterSpacing;
+    const float lineSpacing = font->getLineSpacing(characterSize)*text.getLineSpacing();
+
+    const sf::Transform& transform = text.getTransform();
+    const sf::Color& color = text.getFillColor();
+    const sf::String& string = text.getString();
+
+    float x = 0.0f,
+          y = characterSize;
+    sf::Uint32 prevChar = 0;
+
+    scratch.clear();
+
+    for(size_t i = 0; i < string.getSize(); ++i)
+    {
+        const sf::Uint32 curChar = string[i];
+
+        if(curChar == L'\r') continue;
+
+        x += font->getKerning(prevChar, curChar, characterSize);
+        prevChar = curChar;
+
+        if(curChar == L' ')
+        {
+            x += whitespaceWidth;
+            continue;
+        }
+        else if(curChar == L'\t')
+        {
+            x += whitespaceWidth*4;
+            continue;
+        }
+        else if(curChar == L'\n')
+        {
+            y += lineSpacing;
+            x = 0.0f;
+            continue;
+        }
+
+        const sf::Glyph& glyph = font->getGlyph(curChar, characterSize, bBold);
+
+        const float padding = 1.0f;
+
+        const float left = glyph.bounds.left - padding,
+                    top = glyph.bounds.top - padding,
+                    right = glyph.bounds.left + glyph.bounds.width + padding,
+                    bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+        const float u1 = glyph.textureRect.left - padding,
+                    v1 = glyph.textureRect.top - padding,
+                    u2 = glyph.textureRect.left + glyph.textureRect.width + padding,
+                    v2 = glyph.textureRect.top + glyph.textureRect.height + padding;
+
+        appendQuad(scratch,
+                   sf::Vertex(transform.transformPoint(x + left - italicShear*top, y + top), color, sf::Vector2f(u1, v1)),
+                   sf::Vertex(transform.transformPoint(x + right - italicShear*top, y + top), color, sf::Vector2f(u2, v1)),
+                   sf::Vertex(transform.transformPoint(x + left - italicShear*bottom, y + bottom), color, sf::Vector2f(u1, v2)),
+                   sf::Vertex(transform.transformPoint(x + right - italicShear*bottom, y + bottom), color, sf::Vector2f(u2, v2)));
+
+        x += glyph.advance + letterSpacing;
+    }
+
+    add(&font->getTexture(characterSize), scratch);    // After all glyphs are loaded into the page
+
+}
+
+void CVRenderBatch::draw(sf::RenderTarget* target, const sf::Drawable& drawable)
+{
+
+    if(collecting(target))
+    {
+        flush();
+    }
+
+    target->draw(drawable);
+    ++currentStats.drawCalls;
+
+}
+
+}
@@ -43,9 +43,12 @@
 
 #include "cvision/box.hpp"
 #include "cvision/shape.hpp"
+#include "cvision/shadow.hpp"
 #include "cvision/event.hpp"
 #include "cvision/view.hpp"
 
+#include <typeinfo>
+
 namespace cvis
 {
 
@@ -57,36 +60,56 @@ bool CVBox::draw(sf::RenderTarget* target)
 
     if(bDropShadow)
     {
-        target->draw(dropShadow);
+        View->renderBatch.draw(target, dropShadow);
     }
 
     if(!bSpriteOnly)
     {
         for(auto& item : panel)
         {
-            target->draw(item);
+            View->renderBatch.draw(target, item);
         }
     }
 
-    if(bMasked) target->draw(shapeMask);
+    if(bMasked) View->renderBatch.draw(target, shapeMask);
 
-    for(auto& sprite : spriteList)
-    {
-        target->draw(sprite);
-    }
+    drawSprites(target);
 
     if(is_closable())
     {
-        closeButton->draw(target);
+        drawChild(closeButton, target);
     }
 
-    if(!active) target->draw(inactiveMask);
+    if(!active) View->renderBatch.draw(target, inactiveMask);
 
     CV_DRAW_CLIP_END
 
     return true;
 }
 
+bool CVBox::drawsBatched() const
+{
+    return typeid(*this) == typeid(CVBox);
+}
+
+bool CVBox::shadowOutline(sf::Vector2f& size,
+                          float& rounding,
+                          uint8_t& corners) const
+{
+    if(bSpriteOnly || panel.empty()) return false;
+
+    const rounded_rectangle& outline = panel.front();
+
+    size = outline.getSize();
+    rounding = outline.getRoundingRadius();
+    corners = (outline.topLeftRounded() ? CV_CORNER_TOP_LEFT : 0) |
+              (outline.topRightRounded() ? CV_CORNER_TOP_RIGHT : 0) |
+              (outline.bottomRightRounded() ? CV_CORNER_BOTTOM_RIGHT : 0) |
+              (outline.bottomLeftRounded() ? CV_CORNER_BOTTOM_LEFT : 0);
+
+    return true;
+}
+
 void CVBox::highlight(const bool& state)
 {
     CVElement::highlight(state);
@@ -265,6 +288,8 @@ void CVBox::setSpriteColor(const sf::Color& newColor)
     }
 
     spriteColor = newColor;
+
+    invalidate();
 }
 
 void CVBox::setFillColor(const sf::Color& newColor)
@@ -284,6 +309,8 @@ void CVBox::setFillColor(const sf::Color& newColor)
     {
         bSpriteOnly = false;
     }
+
+    invalidate();
 }
 
 void CVBox::setOutlineColor(const sf::Color& newColor)
@@ -292,6 +319,8 @@ void CVBox::setOutlineColor(const sf::Color& newColor)
     {
         item.setOutlineColor(newColor);
     }
+
+    invalidate();
 }
 
 void CVBox::setTexture(const sf::Texture* texture,
@@ -309,6 +338,8 @@ void CVBox::setTexture(const sf::Texture* texture,
     {
         panel.front().setTexture(texture, true);
     }
+
+    invalidate();
 }
 
 void CVBox::setTexture(const std::string& texture,
@@ -328,6 +359,8 @@ void CVBox::setRounding(const float& radius,
     shapeMask.setRounding(radius, pointCount, states);
     inactiveMask.setRounding(radius, pointCount, states);
 
+    invalidate();
+
 }
 
 const float& CVBox::getRoundingRadius() const
@@ -361,6 +394,8 @@ void CVBox::setOutlineThickness(const float& newThickness)
     {
         item.setOutlineThickness(newThickness);
     }
+
+    invalidate();
 }
 
 void CVBox::setRotation(const float& angle, const unsigned char& flags, const sf::Vector2f& origin)
@@ -87,9 +87,10 @@ CVButton::CVButton(CVView* View,
     if(!icon.empty())
     {
         const sf::Texture* iconTex = View->mainApp->bitmaps.taggedTexture(icon);
-        sf::Vector2f texSize(iconTex->getSize());
+        const sf::IntRect iconRect = View->mainApp->bitmaps.textureRegion(iconTex).rect;   // Known before a lazy icon is decoded
+        sf::Vector2f texSize(iconRect.width, iconRect.height);
 
-        float scale = width < height ? width/iconTex->getSize().x : height/iconTex->getSize().y;
+        float scale = width < height ? width/texSize.x : height/texSize.y;
 
         addSprite(iconTex,
                   sf::Vector2f(width/2, height/2),
@@ -239,7 +240,7 @@ void CVButton::setStateTexture(const unsigned int& state,
 
     if(!spriteList.empty() && (state == stateNum))
     {
-        getSprite(0).setTexture(*stateTextures[state]);
+        setSpriteTexture(getSprite(0), stateTextures[state]);
     }
 }
 
@@ -348,7 +349,7 @@ void CVButton::toggle()
     if(!spriteList.empty() &&
        (stateNum < stateTextures.size()))
     {
-        getSprite(0).setTexture(*stateTextures[stateNum]);
+        setSpriteTexture(getSprite(0), stateTextures[stateNum]);
     }
 
     if(!isnan(rotateAngle))
@@ -418,10 +419,7 @@ bool CVButton::draw(sf::RenderTarget* target)
 
     if(bMasked) target->draw(shapeMask);
 
-    for(auto& spr : spriteList)
-    {
-        target->draw(spr);
-    }
+    drawSprites(target);
     for(auto& text : displayText)
     {
         target->draw(text);
@@ -42,6 +42,7 @@
 /////////////////////////////////////////////////////////////  **/
 
 #include "cvision/color.hpp"
+#include "cvision/imageops.hpp"
 
 #include <hyper/toolkit/string.hpp>
 
@@ -112,15 +113,7 @@ void contrast_brightness(sf::Color& color,
 
 void setImageColor(sf::Image& img, const sf::Color& newColor)
 {
-    size_t x = 0;
-    sf::Vector2u imgSize = img.getSize();
-    for(size_t y = 0; y < imgSize.y; ++y)
-    {
-        for(x = 0; x < imgSize.x; ++x)
-        {
-            img.setPixel(x, y, newColor);
-        }
-    }
+    fill(imageSpan(img), newColor);
 }
 
 sf::Color textToColor(const std::string& input)
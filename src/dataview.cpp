@@ -474,7 +474,7 @@ void CVDataViewerPanel::setup()
 bool CVDataViewerPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
-    if(bNoInteract || !View->viewPort) return false;
+    if(bNoInteract || !View->window_open()) return false;
 
     std::cout << "Updating...\n";
 
@@ -45,6 +45,7 @@
 #include "cvision/algorithm.hpp"
 #include "cvision/button.hpp"
 #include "cvision/view.hpp"
+#include "cvision/viewpanel.hpp"
 #include "cvision/app.hpp"
 
 #include <hyper/toolkit/string.hpp>
@@ -77,12 +78,18 @@ namespace cvis
         bDropShadow(false),\
         bStatic(false),\
         bNoInteract(false),\
+        bIndexed(false),\
+        bBoundsDirty(false),\
+        bSkipWhenIdle(false),\
         closeButton(nullptr),\
         highlightColor(sf::Color::Transparent),\
         origin(0.0f,0.0f),\
         destination(NAN, NAN),\
         velocity(0.0f,0.0f),\
         acceleration(0.0f,0.0f),\
+        physicsPosition(0.0f,0.0f),\
+        physicsLastPosition(0.0f,0.0f),\
+        physicsRenderPosition(NAN,NAN),\
         fMoveAngle(0.0f),\
         fElasticity(1.0f),\
         fFriction(0.0f),\
@@ -93,6 +100,7 @@ namespace cvis
         targetAlpha(255),\
         fadeLayers(CV_LAYER_ALL),\
         fadeRate(0),\
+        dirtyFrame(SIZE_MAX),\
         fTruePos(0.0f,0.0f),\
         iDrawPos(0,0),\
         fTrueSize(0.0f,0.0f),\
@@ -106,7 +114,8 @@ CVElement::CVElement():
     active(true),
     CVELEMENT_INIT
     View(nullptr),
-    drawTarget(nullptr) { }
+    drawTarget(nullptr),
+    viewPanel(nullptr) { }
 
 CVElement::CVElement(CVView* View,
                      bool canHighlight,
@@ -120,13 +129,18 @@ CVElement::CVElement(CVView* View,
     active(active),
     CVELEMENT_INIT
     View(View),
-    drawTarget(View->viewPort) {
+    drawTarget(View->viewPort),
+    viewPanel(nullptr) {
 
     }
 
 CVElement::~CVElement()
 {
     View->releaseMouseCapture(*this);
+    if(bIndexed)
+    {
+        View->unindexTag(IDtag, this);
+    }
     if(is_closable())
     {
         delete(closeButton);
@@ -164,109 +178,41 @@ void CVElement::setClosable(const bool& status,
 bool CVElement::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
-    if(!View->viewPort || !View->viewPort->isOpen())
+    if(!View->window_open())
     {
         return false;
     }
 
+    // Animations keep the view awake and redrawing until they settle
+
+    if((bFade && !fadeComplete()) || (bMove && !bStatic))
+    {
+        invalidate();
+    }
+
     if(bMove && !bStatic)
     {
-        if(!isnan(destination.x) && !isnan(destination.y))
-        {
-            if(getPosition() == destination)
-            {
-                velocity.x = 0.0f;
-                velocity.y = 0.0f;
-                acceleration.x = 0.0f;
-                acceleration.y = 0.0f;
-            }
-            else if(getDistance(getPosition(), destination) - scalar(velocity)*View->getEventTrace().lastFrameTime < 0.0f)
-            {
-                velocity.x = 0.0f;
-                velocity.y = 0.0f;
-                acceleration.x = 0.0f;
-                acceleration.y = 0.0f;
-                setPosition(destination);
-                destination.x = NAN;
-                destination.y = NAN;
-            }
-            else push(get_angle(getPosition(), destination), scalar(velocity), fFriction);
-        }
+        // Integrate on the view's fixed-step clock and draw at a position
+        // interpolated between the last two steps
 
-        if(bStop)
+        if(getPosition() != physicsRenderPosition)  // Moved from outside the simulation
         {
-            if(acceleration.x != 0.0f)
-            {
-                if((velocity.x != 0.0f) && ((abs(velocity.x) - abs(acceleration.x*View->getEventTrace().lastFrameTime)) < 0.0f))
-                {
-                    velocity.x = 0.0f;
-                    acceleration.x = 0.0f;
-                }
-            }
-            if(acceleration.y != 0.0f)
-            {
-                if((velocity.y != 0.0f) && ((abs(velocity.y) - abs(acceleration.y*View->getEventTrace().lastFrameTime)) < 0.0f))
-                {
-                    velocity.y = 0.0f;
-                    acceleration.y = 0.0f;
-                }
-            }
+            physicsPosition = getPosition();
+            physicsLastPosition = physicsPosition;
         }
 
-        if(bBounce)  // Bounce inward
+        for(unsigned int i = 0; bMove && (i < View->getPhysicsSteps()); ++i)
         {
-            if((bounds.left <= View->getBounds().left) && (velocity.x < 0.0f))
-            {
-                velocity.x = -velocity.x*fElasticity; // Horizontal bounce
-                velocity.y *= fElasticity;
-            }
-            else if((bounds.left + bounds.width >= View->getBounds().left + View->getWidth()) && (velocity.x > 0.0f))
-            {
-                velocity.x = -velocity.x*fElasticity;
-                velocity.y *= fElasticity;
-            }
-
-
-            if((bounds.top <= View->getBounds().top) && (velocity.y < 0.0f))
-            {
-                velocity.y = -velocity.y*fElasticity; // Vertical bounce
-                velocity.x *= fElasticity;
-            }
-            else if((bounds.top + bounds.height >= View->getBounds().top + View->getBounds().height) && (velocity.y > 0.0f))
-            {
-                velocity.y = -velocity.y*fElasticity;
-                velocity.x *= fElasticity;
-            }
+            physicsLastPosition = physicsPosition;
+            stepMotion(View->getPhysicsStep());
         }
 
-        if(fFriction != 0.0f)  // Apply frictional force
-        {
-            if(velocity.x > 0.0f)
-            {
-                velocity.x -= abs(fFriction*cos(fMoveAngle)*View->getEventTrace().lastFrameTime);
-                if(velocity.x < 0.0f) velocity.x = 0.0f;
-            }
-            else
-            {
-                velocity.x += abs(fFriction*cos(fMoveAngle)*View->getEventTrace().lastFrameTime);
-                if(velocity.x > 0.0f) velocity.x = 0.0f;
-            }
+        const sf::Vector2f renderPosition = bMove ?
+                    physicsLastPosition + (physicsPosition - physicsLastPosition)*View->getPhysicsAlpha() :
+                    physicsPosition;
 
-            if(velocity.y > 0.0f)
-            {
-                velocity.y -= abs(fFriction*sin(fMoveAngle)*View->getEventTrace().lastFrameTime);
-                if(velocity.y < 0.0f) velocity.y = 0.0f;
-            }
-            else
-            {
-                velocity.y += abs(fFriction*sin(fMoveAngle)*View->getEventTrace().lastFrameTime);
-                if(velocity.y > 0.0f) velocity.y = 0.0f;
-            }
-        }
-
-        velocity += acceleration*View->getEventTrace().lastFrameTime;
-        if((velocity.x == 0.0f) && (velocity.y == 0.0f)) bMove = false;
-        else move(velocity*View->getEventTrace().lastFrameTime);
+        move(renderPosition - getPosition());
+        physicsRenderPosition = getPosition();
     }
 
     if(bNoInteract || !visible) return false;
@@ -562,6 +508,12 @@ const sf::Texture* CVElement::appTexture(const string& tag) const
     return nullptr;
 }
 
+CVTextureRegion CVElement::appTextureRegion(const string& tag) const
+{
+    if(mainApp()) return mainApp()->bitmaps.textureRegion(tag);
+    return { nullptr, sf::IntRect() };
+}
+
 const sf::Image* CVElement::appImage(const string& tag) const
 {
     if(mainApp()) return mainApp()->bitmaps.taggedImage(tag);
@@ -631,27 +583,63 @@ void CVElement::setDropShadow(const bool& state,
 
     if(!bDropShadow && state)
     {
-        getTexture(dropShadowTexture);
+        sf::Vector2f outlineSize;
+        float rounding = 0.0f;
+        uint8_t corners = CV_CORNER_ALL;
 
-        sf::Image tmp = dropShadowTexture.copyToImage();
+        if(shadowOutline(outlineSize, rounding, corners))
+        {
+            sharedShadowTexture = View->shadowCache.get(outlineSize, rounding, corners, radius,
+                                                        View->mainApp ? &View->mainApp->threadPool() : nullptr);
+        }
 
-        modulate(tmp, sf::Color::Black);
-        expand_canvas(tmp, sf::Vector2i(radius*2, radius*2), sf::Color::Red);
-//        gaussianBlur(tmp, radius);
+        if(sharedShadowTexture)
+        {
+            const float margin = CVShadowCache::margin(radius);
 
-        dropShadowTexture.loadFromImage(tmp);
+            dropShadow.setTexture(*sharedShadowTexture, true);
+            dropShadow.setOrigin(sf::Vector2f(margin - offset.x, margin - offset.y));
+            dropShadow.setPosition(getPosition());
+            dropShadow.setScale(scale);
+            dropShadow.setColor(sf::Color(0,0,0,alpha));
+        }
+        else // Capture the rendered element
+        {
+            getTexture(dropShadowTexture);
 
-        dropShadow.setTexture(dropShadowTexture);
-        dropShadow.setOrigin(sf::Vector2f(-offset.x, -offset.y));
-        dropShadow.setPosition(getPosition());
-        dropShadow.setScale(getSize() / dropShadowTexture.getSize() * scale);
-        dropShadow.setColor(sf::Color(255,255,255,alpha));
+            sf::Image tmp = dropShadowTexture.copyToImage();
+
+            modulate(tmp, sf::Color::Black);
+            expand_canvas(tmp, sf::Vector2i(radius*2, radius*2), sf::Color::Transparent);
+            gaussianBlur(tmp, radius, View->mainApp ? &View->mainApp->threadPool() : nullptr);
+
+            dropShadowTexture.loadFromImage(tmp);
+
+            dropShadow.setTexture(dropShadowTexture);
+            dropShadow.setOrigin(sf::Vector2f(-offset.x, -offset.y));
+            dropShadow.setPosition(getPosition());
+            dropShadow.setScale(getSize() / dropShadowTexture.getSize() * scale);
+            dropShadow.setColor(sf::Color(255,255,255,alpha));
+        }
 
     }
+    else if(!state)
+    {
+        sharedShadowTexture.reset();
+    }
 
     bDropShadow = state;
 }
 
+void CVElement::receive_trigger(const string& newTrigger)
+{
+    incoming_triggers.emplace_back(newTrigger);
+    if(View)
+    {
+        View->wake();   // The trigger is processed on the next update cycle
+    }
+}
+
 string CVElement::take_trigger(const string& tag)
 {
     string output;
@@ -737,6 +725,7 @@ void CVElement::setDrawClipping(const bool& status)
 void CVElement::highlight(const bool& state)
 {
     highlighted = state;
+    invalidate();
     if(highlighted)
     {
         for(auto& spr : spriteList)
@@ -764,17 +753,141 @@ void CVElement::setFade(const uint8_t& alpha, const int& rate, const unsigned ch
     targetAlpha = alpha;
     fadeRate = abs(rate);
     fadeLayers = flags;
+    invalidate();
 }
 
-bool CVElement::draw(sf::RenderTarget* target)
+namespace
 {
-    if(target == nullptr) return false;
-    if(!visible) return false;
+thread_local CVInvalidationBoundary* invalidationBoundary = nullptr;
+}
+
+CVInvalidationBoundary::CVInvalidationBoundary(const CVElement* container):
+    container(container),
+    previous(invalidationBoundary),
+    bReached(false),
+    bBoundsReached(false)
+{
+    invalidationBoundary = this;
+}
+
+CVInvalidationBoundary::~CVInvalidationBoundary()
+{
+    invalidationBoundary = previous;
+}
+
+void CVElement::invalidate()
+{
+    if(!View) return;
+
+    if(viewPanel)
+    {
+        viewPanel->markMoved(this);
+        markBoundsDirty();
+    }
+
+    // Propagate through the panel hierarchy only once per frame
+
+    if(dirtyFrame != View->getFrameIndex())
+    {
+        dirtyFrame = View->getFrameIndex();
+        if(viewPanel)
+        {
+            if(invalidationBoundary &&
+               ((const CVElement*)viewPanel == invalidationBoundary->container))
+            {
+                invalidationBoundary->bReached = true;
+            }
+            else viewPanel->invalidate();
+        }
+    }
+
+    View->invalidate();
+}
+
+void CVElement::markBoundsDirty()
+{
+    for(CVViewPanel* owner = viewPanel; owner && owner->bExpand && !owner->bBoundsDirty; owner = owner->viewPanel)
+    {
+        if(invalidationBoundary &&
+           ((const CVElement*)owner == invalidationBoundary->container))
+        {
+            invalidationBoundary->bBoundsReached = true;
+            break;  // The shared container and its ancestors are marked from the view thread
+        }
+
+        owner->bBoundsDirty = true;
+    }
+}
+
+void CVElement::invalidateBounds()
+{
+    if(bExpand && !bBoundsDirty)
+    {
+        bBoundsDirty = true;
+        markBoundsDirty();
+    }
+}
+
+bool CVElement::needsUpdate() const
+{
+    return bFade || bMove || bFollowMouseX || bFollowMouseY ||
+            bHasFocus || highlighted || mouseHovering || clickHeld ||
+            bDelete || bTriggered || !incoming_triggers.empty();
+}
+
+bool CVElement::isDirty() const
+{
+    return View && (dirtyFrame == View->getFrameIndex());
+}
+
+bool CVElement::drawsBatched() const
+{
+    return false;
+}
+
+bool CVElement::shadowOutline(sf::Vector2f& size,
+                              float& rounding,
+                              uint8_t& corners) const
+{
+    return false;
+}
+
+void CVElement::drawChild(CVElement* element, sf::RenderTarget* target)
+{
+    if(!element->drawsBatched() && View->renderBatch.collecting(target))
+    {
+        View->renderBatch.suspend();
+        element->draw(target);
+        View->renderBatch.resume();
+    }
+    else
+    {
+        element->draw(target);
+    }
+}
+
+void CVElement::drawSprites(sf::RenderTarget* target)
+{
+    if(View->mainApp && View->mainApp->bitmaps.hasLazyTextures())
+    {
+        for(auto& sprite : spriteList)
+        {
+            View->mainApp->bitmaps.touch(sprite.getTexture());
+        }
+    }
 
     for(auto& sprite : spriteList)
     {
-        target->draw(sprite);
+        View->renderBatch.draw(target, sprite);
     }
+}
+
+bool CVElement::draw(sf::RenderTarget* target)
+{
+    if(target == nullptr) return false;
+    if(!visible) return false;
+
+    drawSprites(target);
 
     if(bDropShadow)
     {
@@ -883,6 +996,8 @@ void CVElement::move(const sf::Vector2f& distance)
     bounds.left = fTruePos.x;
     bounds.top = fTruePos.y;
 
+    invalidate();
+
 }
 
 void CVElement::setExpand(const bool& state)
@@ -891,6 +1006,17 @@ void CVElement::setExpand(const bool& state)
     updateBounds();
 }
 
+sf::FloatRect CVElement::getViewBounds() const
+{
+    sf::FloatRect output = getBounds();
+    for(const CVViewPanel* owner = viewPanel; owner; owner = owner->viewPanel)
+    {
+        output.left += owner->getContentOffset().x;
+        output.top += owner->getContentOffset().y;
+    }
+    return output;
+}
+
 sf::Vector2f CVElement::getPosition() const
 {
     return fTruePos + origin;
@@ -904,6 +1030,8 @@ void CVElement::setSize(const sf::Vector2f& newSize)
 
     bounds.width = newSize.x;
     bounds.height = newSize.y;
+
+    invalidate();
 }
 
 void CVElement::setElasticity(const float& newElasticity)
@@ -929,6 +1057,119 @@ void CVElement::stop()
     acceleration.y = 0.0f;
 }
 
+void CVElement::stepMotion(const float& timeStep)
+{
+    static const float steeringRate = 60.0f;    // Steps per second the destination push was tuned at
+
+    if(!isnan(destination.x) && !isnan(destination.y))
+    {
+        if(physicsPosition == destination)
+        {
+            velocity.x = 0.0f;
+            velocity.y = 0.0f;
+            acceleration.x = 0.0f;
+            acceleration.y = 0.0f;
+        }
+        else if(getDistance(physicsPosition, destination) - scalar(velocity)*timeStep < 0.0f)
+        {
+            velocity.x = 0.0f;
+            velocity.y = 0.0f;
+            acceleration.x = 0.0f;
+            acceleration.y = 0.0f;
+            physicsPosition = destination;
+            destination.x = NAN;
+            destination.y = NAN;
+        }
+        else
+        {
+            // Steer toward the destination.  Scaling the push to the step keeps the
+            // growth in speed per second the same at any step rate
+
+            push(get_angle(physicsPosition, destination),
+                 scalar(velocity)*(pow(2.0f, timeStep*steeringRate) - 1.0f), fFriction);
+        }
+    }
+
+    if(bStop)
+    {
+        if(acceleration.x != 0.0f)
+        {
+            if((velocity.x != 0.0f) && ((abs(velocity.x) - abs(acceleration.x*timeStep)) < 0.0f))
+            {
+                velocity.x = 0.0f;
+                acceleration.x = 0.0f;
+            }
+        }
+        if(acceleration.y != 0.0f)
+        {
+            if((velocity.y != 0.0f) && ((abs(velocity.y) - abs(acceleration.y*timeStep)) < 0.0f))
+            {
+                velocity.y = 0.0f;
+                acceleration.y = 0.0f;
+            }
+        }
+    }
+
+    if(bBounce)  // Bounce inward
+    {
+        sf::FloatRect simBounds = bounds;   // Bounds at the simulated position
+        simBounds.left += physicsPosition.x - getPosition().x;
+        simBounds.top += physicsPosition.y - getPosition().y;
+
+        if((simBounds.left <= View->getBounds().left) && (velocity.x < 0.0f))
+        {
+            velocity.x = -velocity.x*fElasticity; // Horizontal bounce
+            velocity.y *= fElasticity;
+        }
+        else if((simBounds.left + simBounds.width >= View->getBounds().left + View->getWidth()) && (velocity.x > 0.0f))
+        {
+            velocity.x = -velocity.x*fElasticity;
+            velocity.y *= fElasticity;
+        }
+
+
+        if((simBounds.top <= View->getBounds().top) && (velocity.y < 0.0f))
+        {
+            velocity.y = -velocity.y*fElasticity; // Vertical bounce
+            velocity.x *= fElasticity;
+        }
+        else if((simBounds.top + simBounds.height >= View->getBounds().top + View->getBounds().height) && (velocity.y > 0.0f))
+        {
+            velocity.y = -velocity.y*fElasticity;
+            velocity.x *= fElasticity;
+        }
+    }
+
+    if(fFriction != 0.0f)  // Apply frictional force
+    {
+        if(velocity.x > 0.0f)
+        {
+            velocity.x -= abs(fFriction*cos(fMoveAngle)*timeStep);
+            if(velocity.x < 0.0f) velocity.x = 0.0f;
+        }
+        else
+        {
+            velocity.x += abs(fFriction*cos(fMoveAngle)*timeStep);
+            if(velocity.x > 0.0f) velocity.x = 0.0f;
+        }
+
+        if(velocity.y > 0.0f)
+        {
+            velocity.y -= abs(fFriction*sin(fMoveAngle)*timeStep);
+            if(velocity.y < 0.0f) velocity.y = 0.0f;
+        }
+        else
+        {
+            velocity.y += abs(fFriction*sin(fMoveAngle)*timeStep);
+            if(velocity.y > 0.0f) velocity.y = 0.0f;
+        }
+    }
+
+    velocity += acceleration*timeStep;
+    if((velocity.x == 0.0f) && (velocity.y == 0.0f)) bMove = false;
+    else physicsPosition += velocity*timeStep;
+}
+
 void CVElement::move_to(const sf::Vector2f& position,
                         const float& velocity,
                         const float& drag)
@@ -936,9 +1177,9 @@ void CVElement::move_to(const sf::Vector2f& position,
     if(bStatic) return;
 
     bNoInteract = false;
+    fMoveAngle = get_angle(simulatedPosition(), position);
     bMove = true;
     destination = position;
-    fMoveAngle = get_angle(getPosition(), position);
     this->velocity = components(velocity, fMoveAngle);
     fFriction = abs(drag);
 }
@@ -957,17 +1198,12 @@ void CVElement::anim_move(const sf::Vector2f& distance,
 
     bNoInteract = false;
 
-    if(!bMove)
-    {
-        destination = getPosition() + distance;
-        bMove = true;
-    }
-    else
-    {
-        destination = getPosition() + distance;
-    }
+    const sf::Vector2f start = simulatedPosition();
+
+    destination = start + distance;
+    bMove = true;
 
-    fMoveAngle = get_angle(getPosition(), destination);
+    fMoveAngle = get_angle(start, destination);
     this->velocity = components(velocity, fMoveAngle);
     fFriction = abs(drag);
 }
@@ -996,6 +1232,20 @@ const CVApp* CVElement::mainApp() const
     return View->mainApp;
 }
 
+void CVElement::setTag(const string& newTag)
+{
+    if(bIndexed && (newTag != IDtag))
+    {
+        View->unindexTag(IDtag, this);
+        IDtag = newTag;
+        View->indexTag(IDtag, this);
+    }
+    else
+    {
+        IDtag = newTag;
+    }
+}
+
 CVElement* CVElement::getElementById(const string& tag)
 {
     return View->getElementById(tag);
@@ -1016,9 +1266,17 @@ void CVElement::addSprite(const sf::Texture* texture,
         spriteColor = fillColor;
     }
 
+    // Draw from the atlas page when the texture has been packed, so that
+    // icons from the same page can share a batch.  Lazy textures are sized
+    // from their source header and decoded when first drawn
+
+    CVTextureRegion region = mainApp() ? mainApp()->bitmaps.textureRegion(texture) :
+                                         CVTextureRegion{ texture, sf::IntRect(0, 0, texture->getSize().x, texture->getSize().y) };
+
     spriteList.emplace_back();
-    spriteList.back().setTexture(*texture, true);
-    sf::Vector2u texSize = texture->getSize();
+    spriteList.back().setTexture(*region.texture);
+    spriteList.back().setTextureRect(region.rect);
+    sf::Vector2u texSize(region.rect.width, region.rect.height);
 
     if(isnan(size.x))
     {
@@ -1041,7 +1299,9 @@ void CVElement::addSprite(const sf::Texture* texture,
 
     if(subRect.width && subRect.height)
     {
-        spriteList.back().setTextureRect(subRect);
+        spriteList.back().setTextureRect(sf::IntRect(region.rect.left + subRect.left,
+                                                     region.rect.top + subRect.top,
+                                                     subRect.width, subRect.height));
         spriteList.back().setOrigin(std::round(subRect.width/2), std::round(subRect.height/2));
     }
     else
@@ -1052,6 +1312,8 @@ void CVElement::addSprite(const sf::Texture* texture,
     spriteList.back().setPosition(std::round(bounds.left + position.x),
                                   std::round(bounds.top + position.y));
     spriteList.back().setColor(fillColor);
+
+    invalidate();
 }
 
 void CVElement::removeSprites(const string& tag)
@@ -1059,24 +1321,39 @@ void CVElement::removeSprites(const string& tag)
     size_t L = spriteList.size();
     for(size_t i = 0; i < L;)
     {
-        if(mainApp()->bitmaps.getTextureName(spriteList[i].getTexture()) == tag)
+        if(mainApp()->bitmaps.getTextureName(spriteList[i].getTexture(),
+                                             spriteList[i].getTextureRect()) == tag)
         {
             spriteList.erase(spriteList.begin() + i);
             --L;
         }
         else ++i;
     }
+
+    invalidate();
 }
 
 bool CVElement::has_sprite(const string& tag) const
 {
     for(auto& sprite : spriteList)
     {
-        if(mainApp()->bitmaps.getTextureName(sprite.getTexture()) == tag) return true;
+        if(mainApp()->bitmaps.getTextureName(sprite.getTexture(),
+                                             sprite.getTextureRect()) == tag) return true;
     }
     return false;
 }
 
+void CVElement::setSpriteTexture(sf::Sprite& sprite, const sf::Texture* texture) const
+{
+    if(!texture) return;
+
+    CVTextureRegion region = mainApp() ? mainApp()->bitmaps.textureRegion(texture) :
+                                         CVTextureRegion{ texture, sf::IntRect(0, 0, texture->getSize().x, texture->getSize().y) };
+
+    sprite.setTexture(*region.texture);
+    sprite.setTextureRect(region.rect);
+}
+
 sf::Sprite& CVElement::lastSprite()
 {
     if(spriteList.empty()) throw invalid_argument("No sprites in sprite list to index");
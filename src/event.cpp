@@ -45,6 +45,8 @@
 #include "cvision/element.hpp"
 #include "cvision/algorithm.hpp"
 
+#include <cstring>
+
 namespace cvis
 {
 
@@ -155,6 +157,23 @@ bool CVEvent::checkCond(const unsigned char& cond, const sf::Keyboard::Key& keyC
     return status;
 }
 
+void CVEvent::translateMouse(const sf::Vector2f& offset)
+{
+    LMBpressPosition += offset;
+    RMBpressPosition += offset;
+    lastFrameMousePosition += offset;
+    currentMousePosition += offset;
+    LMBreleasePosition += offset;
+    RMBreleasePosition += offset;
+    lastLMBpressPosition += offset;
+    lastRMBpressPosition += offset;
+
+    for(auto& position : mouseTraceBuffer)
+    {
+        position += offset;
+    }
+}
+
 void CVEvent::moveCapturedShapes()
 {
     for(auto& capref : mouseCapturedShapes)
@@ -365,5 +384,105 @@ std::ostream& operator<<(std::ostream& output, const CVEvent& event)
     return output;
 }
 
+namespace
+{
+
+inline bool sameData(const CVData& lhs, const CVData& rhs)
+{
+    return (lhs.infoType == rhs.infoType) &&
+            (lhs.releaseCond == rhs.releaseCond) &&
+            (lhs.releaseKey == rhs.releaseKey) &&
+            (lhs.length == rhs.length) &&
+            (!lhs.length || !memcmp(lhs.data, rhs.data, lhs.length));
+}
+
+// Apply the entries removed from and added to [base] by [result] onto [target],
+// counting duplicates (ie. repeated keys)
+
+template<typename T, typename Equal>
+void mergeSequence(std::vector<T>& target, const std::vector<T>& base,
+                   const std::vector<T>& result, Equal equal)
+{
+
+    std::vector<const T*> added;
+    added.reserve(result.size());
+    for(auto& item : result)
+    {
+        added.push_back(&item);
+    }
+
+    for(auto& item : base)
+    {
+        bool bKept = false;
+        for(size_t i = 0; i < added.size(); ++i)
+        {
+            if(equal(item, *added[i]))
+            {
+                added.erase(added.begin() + i);
+                bKept = true;
+                break;
+            }
+        }
+
+        if(!bKept)
+        {
+            for(size_t i = 0; i < target.size(); ++i)
+            {
+                if(equal(item, target[i]))
+                {
+                    target.erase(target.begin() + i);
+                    break;
+                }
+            }
+        }
+    }
+
+    for(auto& item : added)
+    {
+        target.push_back(*item);
+    }
+
+}
+
+}
+
+void CVEvent::mergeChanges(const CVEvent& base, const CVEvent& result)
+{
+
+    // Results are merged in serial update order.  Mouse and focus claims go
+    // to the first panel to make them, as they would serially, where a later
+    // panel would have seen the claim and been refused.  Other fields
+    // changed by a later panel override an earlier one
+
+    #define CV_MERGE_CLAIM(field) if((result.field != base.field) && (field == base.field)) field = result.field
+    #define CV_MERGE_FIELD(field) if(result.field != base.field) field = result.field
+
+    CV_MERGE_CLAIM(mouseCaptured);
+    CV_MERGE_CLAIM(focusCaptured);
+
+    #undef CV_MERGE_CLAIM
+
+    CV_MERGE_FIELD(keyPressed);
+    CV_MERGE_FIELD(eventsProcessed);
+    CV_MERGE_FIELD(closeSignal);
+    CV_MERGE_FIELD(viewClosed);
+    CV_MERGE_FIELD(timeLastKey);
+    CV_MERGE_FIELD(zoomDelta);
+    CV_MERGE_FIELD(zoomState);
+    CV_MERGE_FIELD(wheelDirection);
+    CV_MERGE_FIELD(mouseWheelDelta);
+    CV_MERGE_FIELD(awaitingCursorType);
+
+    #undef CV_MERGE_FIELD
+
+    mergeSequence(keyLog, base.keyLog, result.keyLog,
+                  [](const uint32_t& lhs, const uint32_t& rhs){ return lhs == rhs; });
+    mergeSequence(transferData, base.transferData, result.transferData, sameData);
+    mergeSequence(mouseCapturedShapes, base.mouseCapturedShapes, result.mouseCapturedShapes,
+                  [](const CVCaptureRef& lhs, const CVCaptureRef& rhs){ return lhs.item == rhs.item; });
+    mergeSequence(drop_data, base.drop_data, result.drop_data,
+                  [](const std::string& lhs, const std::string& rhs){ return lhs == rhs; });
+
+}
 
 }
@@ -0,0 +1,338 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/headless.hpp"
+#include "cvision/app.hpp"
+
+using namespace std;
+
+namespace cvis
+{
+
+#define CV_HEADLESS_FRAME_BREAK        sf::Event::Count    // Queue marker separating synthetic frames
+
+CVHeadlessView::CVHeadlessView(unsigned int x, unsigned int y,
+                               CVApp* mainApp,
+                               const bool& render,
+                               const sf::Color& backgroundColor):
+    CVView(x, y, "Headless view", sf::Style::None, mainApp,
+           sf::Vector2f(NAN, NAN), backgroundColor),
+    bRender(render),
+    bOpen(true),
+    syntheticMousePos(0.0f, 0.0f)
+{
+
+    if(bRender && !renderTarget.create(x, y))
+    {
+        cout << "Warning (CVision): failed to create off-screen render target, rendering disabled\n";
+        bRender = false;
+    }
+
+    moveTarget = sf::Vector2i(0, 0);
+    mousePos = sf::Vector2f(0.0f, 0.0f);
+
+    eventTrace.viewBounds = sf::FloatRect(0.0f, 0.0f, width, height);
+    eventTrace.lastViewBounds = eventTrace.viewBounds;
+    eventTrace.lastFrameMousePosition = mousePos;
+    eventTrace.viewHasFocus = true;
+
+    setState(VIEW_STATE_MAIN);
+
+}
+
+bool CVHeadlessView::window_open() const
+{
+    return bOpen && !bClosed && !forceClose;
+}
+
+bool CVHeadlessView::hasViewFocus() const
+{
+    return inputQueue.replayFrame() ? inputQueue.replayFrame()->focus : true;
+}
+
+sf::Vector2f CVHeadlessView::getGlobalMousePosition() const
+{
+    return inputQueue.replayFrame() ? sf::Vector2f(inputQueue.replayFrame()->globalMousePosition) : mousePos;
+}
+
+bool CVHeadlessView::pollViewEvent(sf::Event& event)
+{
+
+    if(!inputQueue.replaying() && (inputDrainFrame != frameIndex))
+    {
+        // Move this frame's synthetic events through the input queue
+
+        inputDrainFrame = frameIndex;
+
+        while(!syntheticEvents.empty())
+        {
+            const sf::Event next = syntheticEvents.front();
+            syntheticEvents.pop_front();
+
+            if(next.type == CV_HEADLESS_FRAME_BREAK)
+            {
+                break;  // Remaining events belong to the next frame
+            }
+
+            inputQueue.push(next);
+        }
+    }
+
+    if(!inputQueue.pop(event))
+    {
+        return false;
+    }
+
+    if(event.type == sf::Event::MouseMoved)
+    {
+        mousePos.x = event.mouseMove.x;
+        mousePos.y = event.mouseMove.y;
+    }
+
+    return true;
+
+}
+
+unsigned int CVHeadlessView::step(const unsigned int& frames,
+                                  const float& frameTime)
+{
+
+    unsigned int processed = 0;
+
+    while((processed < frames) && window_open())
+    {
+
+        profiler.beginFrame();
+
+        if(!preDrawProcess()) break;
+
+        if(forceClose)
+        {
+            bOpen = false;
+            break;
+        }
+
+        eventTrace.lastFrameTime = frameTime;
+
+        if(!replayInputFrame())
+        {
+            inputQueue.beginFrame(frameTime, sf::Vector2i(mousePos), sf::Vector2i(mousePos), true);
+        }
+
+        mainApp->setContextActive();
+
+        {
+            CV_PROFILE_SCOPE(profiler, "update", "view");
+            update(eventTrace, mousePos);
+        }
+
+        if(bClosed) break;
+
+        const bool bFrameDirty = bDirty.exchange(false);
+
+        if(bDirtyTracking && !bFrameDirty)
+        {
+            ++skippedFrames;
+        }
+        else if(bRender)
+        {
+            CV_PROFILE_SCOPE(profiler, "draw", "view");
+            renderFrame();
+        }
+
+        postDrawProcess();
+
+        frameRate = 1.0f/eventTrace.avgFrameTime;
+
+        ++frameIndex;
+        ++processed;
+
+    }
+
+    profiler.endFrame();    // Each beginFrame closes the frame before it; this closes the last, including on break
+
+    return processed;
+
+}
+
+void CVHeadlessView::renderFrame()
+{
+
+    if(renderTarget.getSize() != sf::Vector2u(width, height))
+    {
+        renderTarget.create(width, height);
+    }
+
+    if(renderTarget.setActive(true))
+    {
+        renderTarget.clear(backgroundColor);
+        draw(&renderTarget);
+        renderTarget.display();
+    }
+
+    while(!saveRequestFiles.empty())
+    {
+        saveFrame(saveRequestFiles.front());
+        saveRequestFiles.erase(saveRequestFiles.begin());
+    }
+
+    if(!frameOutput.empty())
+    {
+        saveFrame(frameOutput + "/frame_" + to_string(frameIndex) + ".png");
+    }
+
+    mainApp->setContextActive();
+
+}
+
+void CVHeadlessView::setFrameOutput(const string& directory)
+{
+    frameOutput = directory;
+    while(!frameOutput.empty() &&
+          ((frameOutput.back() == '/') || (frameOutput.back() == '\\')))
+    {
+        frameOutput.pop_back();
+    }
+}
+
+bool CVHeadlessView::saveFrame(const string& filename) const
+{
+    return renderTarget.getTexture().copyToImage().saveToFile(filename);
+}
+
+void CVHeadlessView::postEvent(const sf::Event& event)
+{
+    if(event.type == sf::Event::MouseMoved)
+    {
+        syntheticMousePos = sf::Vector2f(event.mouseMove.x, event.mouseMove.y);
+    }
+
+    syntheticEvents.push_back(event);
+}
+
+void CVHeadlessView::moveMouse(const sf::Vector2f& position)
+{
+    sf::Event event;
+    event.type = sf::Event::MouseMoved;
+    event.mouseMove.x = std::round(position.x);
+    event.mouseMove.y = std::round(position.y);
+    postEvent(event);
+}
+
+void CVHeadlessView::pressMouse(const sf::Mouse::Button& button)
+{
+    sf::Event event;
+    event.type = sf::Event::MouseButtonPressed;
+    event.mouseButton.button = button;
+    event.mouseButton.x = std::round(syntheticMousePos.x);
+    event.mouseButton.y = std::round(syntheticMousePos.y);
+    postEvent(event);
+}
+
+void CVHeadlessView::releaseMouse(const sf::Mouse::Button& button)
+{
+    sf::Event event;
+    event.type = sf::Event::MouseButtonReleased;
+    event.mouseButton.button = button;
+    event.mouseButton.x = std::round(syntheticMousePos.x);
+    event.mouseButton.y = std::round(syntheticMousePos.y);
+    postEvent(event);
+}
+
+void CVHeadlessView::click(const sf::Vector2f& position,
+                           const sf::Mouse::Button& button)
+{
+    moveMouse(position);
+    pressMouse(button);
+
+    // Press and release must land in separate frames for
+    // elements that react to the first frame of a held button
+
+    sf::Event frameBreak;
+    frameBreak.type = CV_HEADLESS_FRAME_BREAK;
+    postEvent(frameBreak);
+
+    releaseMouse(button);
+}
+
+void CVHeadlessView::scrollWheel(const float& delta,
+                                 const sf::Mouse::Wheel& wheel)
+{
+    sf::Event event;
+    event.type = sf::Event::MouseWheelScrolled;
+    event.mouseWheelScroll.wheel = wheel;
+    event.mouseWheelScroll.delta = delta;
+    event.mouseWheelScroll.x = std::round(syntheticMousePos.x);
+    event.mouseWheelScroll.y = std::round(syntheticMousePos.y);
+    postEvent(event);
+}
+
+void CVHeadlessView::pressKey(const sf::Keyboard::Key& key)
+{
+    sf::Event event;
+    event.type = sf::Event::KeyPressed;
+    event.key.code = key;
+    event.key.alt = false;
+    event.key.control = false;
+    event.key.shift = false;
+    event.key.system = false;
+    postEvent(event);
+
+    event.type = sf::Event::KeyReleased;
+    postEvent(event);
+}
+
+void CVHeadlessView::typeText(const string& text)
+{
+    sf::Event event;
+    event.type = sf::Event::TextEntered;
+
+    const sf::String input(text);
+    for(size_t i = 0; i < input.getSize(); ++i)
+    {
+        event.text.unicode = input[i];
+        postEvent(event);
+    }
+}
+
+}
@@ -0,0 +1,914 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/imageops.hpp"
+#include "cvision/threadpool.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define CV_IMAGEOPS_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cvis
+{
+
+static const size_t parallelMinPixels = 256*256; // Smaller images are not worth the hand-off
+
+// Run task over [0, count) in contiguous strips, across the pool if the image is large enough
+
+static void forStrips(const size_t& count,
+                      const size_t& numPixels,
+                      CVThreadPool* pool,
+                      const function<void(const size_t&, const size_t&)>& task)
+{
+    if(!pool || (numPixels < parallelMinPixels) || (count < 2))
+    {
+        task(0, count);
+        return;
+    }
+
+    const size_t numStrips = min(count, 4*(pool->size() + 1));
+    pool->parallelFor(numStrips, [&](const size_t& i)
+    {
+        task(i*count/numStrips, (i + 1)*count/numStrips);
+    });
+}
+
+template<typename RowOp>
+static void forEachRow(const CVImageSpan& image,
+                       CVThreadPool* pool,
+                       const RowOp& op)
+{
+    if(!image.width || !image.height) return;
+
+    forStrips(image.height, size_t(image.width)*image.height, pool,
+              [&](const size_t& begin, const size_t& end)
+    {
+        for(size_t y = begin; y < end; ++y)
+        {
+            op(image.row(y), y);
+        }
+    });
+}
+
+CVImageSpan CVImageSpan::clip(const sf::IntRect& bounds) const noexcept
+{
+    const int64_t left = max<int64_t>(bounds.left, 0),
+                  top = max<int64_t>(bounds.top, 0),
+                  right = min<int64_t>(int64_t(bounds.left) + bounds.width, width),
+                  bottom = min<int64_t>(int64_t(bounds.top) + bounds.height, height);
+
+    if((right <= left) || (bottom <= top)) return CVImageSpan(pixels, 0, 0, stride);
+    return CVImageSpan(at(left, top), right - left, bottom - top, stride);
+}
+
+CVImageSpan imageSpan(sf::Image& image)
+{
+    const sf::Vector2u size = image.getSize();
+    if(!size.x || !size.y) return CVImageSpan(nullptr, 0, 0);
+
+    // sf::Image keeps its pixels in its own mutable storage and only lacks
+    // a non-const accessor, so writing through this pointer is sound
+
+    return CVImageSpan(const_cast<uint8_t*>(image.getPixelsPtr()), size.x, size.y);
+}
+
+/** ========================================================================
+
+    Running box sums.  One pixel's four channels are summed in the four
+    32 bit lanes of a vector register.
+
+// ===================================================================== **/
+
+#ifdef CV_IMAGEOPS_SSE2
+
+typedef __m128i PixelSum;
+
+inline static PixelSum loadPixel(const uint8_t* pixel)
+{
+    int32_t value;
+    memcpy(&value, pixel, 4);
+
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+}
+
+inline static PixelSum zeroSum(){ return _mm_setzero_si128(); }
+inline static PixelSum addSum(const PixelSum& a, const PixelSum& b){ return _mm_add_epi32(a, b); }
+inline static PixelSum subSum(const PixelSum& a, const PixelSum& b){ return _mm_sub_epi32(a, b); }
+inline static PixelSum scaleSum(const PixelSum& a, const int32_t& n){ return _mm_madd_epi16(a, _mm_set1_epi32(n)); } // n < 2^15
+
+inline static PixelSum loadSum(const int32_t* sum){ return _mm_loadu_si128((const __m128i*)sum); }
+inline static void storeSum(int32_t* sum, const PixelSum& value){ _mm_storeu_si128((__m128i*)sum, value); }
+
+inline static void storePixel(uint8_t* pixel, const PixelSum& sum, const float& scale)
+{
+    __m128 value = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(scale)), _mm_set1_ps(0.5f));
+    __m128i result = _mm_cvttps_epi32(value);
+    result = _mm_packs_epi32(result, result);
+    result = _mm_packus_epi16(result, result);
+
+    int32_t output = _mm_cvtsi128_si32(result);
+    memcpy(pixel, &output, 4);
+}
+
+#else
+
+struct PixelSum
+{
+    int32_t c[4];
+};
+
+inline static PixelSum loadPixel(const uint8_t* pixel)
+{
+    return {{ pixel[0], pixel[1], pixel[2], pixel[3] }};
+}
+
+inline static PixelSum zeroSum(){ return {{ 0, 0, 0, 0 }}; }
+inline static PixelSum addSum(const PixelSum& a, const PixelSum& b){ return {{ a.c[0] + b.c[0], a.c[1] + b.c[1], a.c[2] + b.c[2], a.c[3] + b.c[3] }}; }
+inline static PixelSum subSum(const PixelSum& a, const PixelSum& b){ return {{ a.c[0] - b.c[0], a.c[1] - b.c[1], a.c[2] - b.c[2], a.c[3] - b.c[3] }}; }
+inline static PixelSum scaleSum(const PixelSum& a, const int32_t& n){ return {{ a.c[0]*n, a.c[1]*n, a.c[2]*n, a.c[3]*n }}; }
+
+inline static PixelSum loadSum(const int32_t* sum){ return {{ sum[0], sum[1], sum[2], sum[3] }}; }
+inline static void storeSum(int32_t* sum, const PixelSum& value){ memcpy(sum, value.c, sizeof(value.c)); }
+
+inline static void storePixel(uint8_t* pixel, const PixelSum& sum, const float& scale)
+{
+    for(size_t i = 0; i < 4; ++i)
+    {
+        pixel[i] = min(255, int(sum.c[i]*scale + 0.5f));
+    }
+}
+
+#endif
+
+static void boxBlurRows(const CVImageSpan& source,
+                        const CVImageSpan& output,
+                        const unsigned int& radius,
+                        const size_t& begin,
+                        const size_t& end)
+{
+    const int W = source.width,
+              R = radius;
+    const float scale = 1.0f/(2*R + 1);
+
+    for(size_t y = begin; y < end; ++y)
+    {
+        const uint8_t* src = source.row(y);
+        uint8_t* dst = output.row(y);
+
+        PixelSum sum = scaleSum(loadPixel(src), R + 1);
+        for(int i = 1; i <= R; ++i)
+        {
+            sum = addSum(sum, loadPixel(src + min(i, W - 1)*4));
+        }
+
+        for(int x = 0; x < W; ++x)
+        {
+            storePixel(dst + x*4, sum, scale);
+            sum = addSum(sum, loadPixel(src + min(x + R + 1, W - 1)*4));
+            sum = subSum(sum, loadPixel(src + max(x - R, 0)*4));
+        }
+    }
+}
+
+static void boxBlurColumns(const CVImageSpan& source,
+                           const CVImageSpan& output,
+                           const unsigned int& radius,
+                           const size_t& begin,
+                           const size_t& end)
+{
+    const int H = source.height,
+              R = radius;
+    const float scale = 1.0f/(2*R + 1);
+    const size_t L = end - begin;
+
+    // Column sums for the strip, advanced a row at a time so that
+    // every access runs along a row
+
+    vector<int32_t> sums(L*4);
+
+    for(size_t x = 0; x < L; ++x)
+    {
+        PixelSum sum = scaleSum(loadPixel(source.at(begin + x, 0)), R + 1);
+        for(int i = 1; i <= R; ++i)
+        {
+            sum = addSum(sum, loadPixel(source.at(begin + x, min(i, H - 1))));
+        }
+        storeSum(&sums[x*4], sum);
+    }
+
+    for(int y = 0; y < H; ++y)
+    {
+        const uint8_t* added = source.at(begin, min(y + R + 1, H - 1));
+        const uint8_t* removed = source.at(begin, max(y - R, 0));
+        uint8_t* dst = output.at(begin, y);
+
+        for(size_t x = 0; x < L; ++x)
+        {
+            PixelSum sum = loadSum(&sums[x*4]);
+            storePixel(dst + x*4, sum, scale);
+
+            sum = addSum(sum, loadPixel(added + x*4));
+            sum = subSum(sum, loadPixel(removed + x*4));
+            storeSum(&sums[x*4], sum);
+        }
+    }
+}
+
+static void boxPass(const CVImageSpan& source,
+                    const CVImageSpan& output,
+                    const unsigned int& radius,
+                    const bool& horizontal,
+                    CVThreadPool* pool)
+{
+    const size_t numPixels = size_t(source.width)*source.height;
+    const unsigned int R = min(radius, 32766u); // Wider boxes only repeat the edge pixels
+
+    if(horizontal)
+    {
+        forStrips(source.height, numPixels, pool, [&](const size_t& begin, const size_t& end)
+        {
+            boxBlurRows(source, output, R, begin, end);
+        });
+    }
+    else
+    {
+        forStrips(source.width, numPixels, pool, [&](const size_t& begin, const size_t& end)
+        {
+            boxBlurColumns(source, output, R, begin, end);
+        });
+    }
+}
+
+void boxBlur(CVImageSpan image,
+             const unsigned int& radius,
+             CVThreadPool* pool)
+{
+    if(!radius || !image.width || !image.height) return;
+
+    vector<uint8_t> buffer(size_t(image.width)*image.height*4);
+    CVImageSpan tmp(buffer, image.width, image.height);
+
+    boxPass(image, tmp, radius, true, pool);
+    boxPass(tmp, image, radius, false, pool);
+}
+
+void gaussianBlur(CVImageSpan image,
+                  const float& sigma,
+                  CVThreadPool* pool)
+{
+    if(!(sigma > 0.0f) || !image.width || !image.height) return;
+
+    // Box widths whose three-fold convolution best matches the variance
+
+    const int n = 3;
+    const float var12 = 12*sigma*sigma;
+
+    int wl = floor(sqrt(var12/n + 1));
+    if(wl % 2 == 0) --wl;
+
+    const int m = round((var12 - n*wl*wl - 4*n*wl - 3*n)/(-4*wl - 4));
+
+    unsigned int radii[3];
+    for(int i = 0; i < n; ++i)
+    {
+        radii[i] = ((i < m ? wl : wl + 2) - 1)/2;
+    }
+
+    vector<uint8_t> buffer(size_t(image.width)*image.height*4);
+    CVImageSpan tmp(buffer, image.width, image.height);
+
+    // Ping-pong so that the last pass writes back into the image
+
+    boxPass(image, tmp, radii[0], true, pool);
+    boxPass(tmp, image, radii[1], true, pool);
+    boxPass(image, tmp, radii[2], true, pool);
+
+    boxPass(tmp, image, radii[0], false, pool);
+    boxPass(image, tmp, radii[1], false, pool);
+    boxPass(tmp, image, radii[2], false, pool);
+}
+
+/** ========================================================================
+
+    Pixel rows.  Products of two channels fit in 16 bits, so SSE2 handles
+    two pixels per 16 bit half of a register, four at a time.
+
+// ===================================================================== **/
+
+inline static uint32_t packColor(const sf::Color& color)
+{
+    const uint8_t channels[4] = { color.r, color.g, color.b, color.a };
+
+    uint32_t value;
+    memcpy(&value, channels, 4);
+    return value;
+}
+
+inline static unsigned int divRound255(const unsigned int& x){ return (x + 128 + ((x + 128) >> 8)) >> 8; }
+inline static unsigned int divFloor255(const unsigned int& x){ return (x + 1 + (x >> 8)) >> 8; } // x <= 255*255
+
+#ifdef CV_IMAGEOPS_SSE2
+
+inline static __m128i divRound255(const __m128i& x)
+{
+    const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+inline static __m128i divFloor255(const __m128i& x)
+{
+    const __m128i t = _mm_add_epi16(x, _mm_set1_epi16(1));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Each pixel's alpha in its colour lanes, and 255 in its alpha lane
+
+inline static __m128i alphaFactors(const __m128i& pixels)
+{
+    __m128i alpha = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3,3,3,3));
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3,3,3,3));
+
+    return _mm_or_si128(_mm_and_si128(alpha, _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0)),
+                        _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255));
+}
+
+#endif
+
+static void fillRow(uint8_t* row, const size_t& length, const uint32_t& value)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i pattern = _mm_set1_epi32(int32_t(value));
+    for(; i + 4 <= length; i += 4)
+    {
+        _mm_storeu_si128((__m128i*)(row + i*4), pattern);
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        memcpy(row + i*4, &value, 4);
+    }
+}
+
+static void recolorRow(uint8_t* row, const size_t& length, const uint32_t& color, const uint32_t& alphaMask)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i colorPattern = _mm_set1_epi32(int32_t(color)),
+                  alphaPattern = _mm_set1_epi32(int32_t(alphaMask));
+    for(; i + 4 <= length; i += 4)
+    {
+        __m128i* pixels = (__m128i*)(row + i*4);
+        _mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(pixels), alphaPattern), colorPattern));
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        uint32_t pixel;
+        memcpy(&pixel, row + i*4, 4);
+        pixel = (pixel & alphaMask) | color;
+        memcpy(row + i*4, &pixel, 4);
+    }
+}
+
+static void tintRow(uint8_t* row, const size_t& length, const sf::Color& color)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i zero = _mm_setzero_si128(),
+                  factors = _mm_setr_epi16(color.r, color.g, color.b, color.a,
+                                           color.r, color.g, color.b, color.a);
+    for(; i + 4 <= length; i += 4)
+    {
+        __m128i* pixels = (__m128i*)(row + i*4);
+        const __m128i value = _mm_loadu_si128(pixels);
+
+        const __m128i low = divRound255(_mm_mullo_epi16(_mm_unpacklo_epi8(value, zero), factors)),
+                      high = divRound255(_mm_mullo_epi16(_mm_unpackhi_epi8(value, zero), factors));
+
+        _mm_storeu_si128(pixels, _mm_packus_epi16(low, high));
+    }
+#endif
+
+    const uint8_t channels[4] = { color.r, color.g, color.b, color.a };
+    for(; i < length; ++i)
+    {
+        for(size_t c = 0; c < 4; ++c)
+        {
+            row[i*4 + c] = divRound255(row[i*4 + c]*channels[c]);
+        }
+    }
+}
+
+static void premultiplyRow(uint8_t* row, const size_t& length)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for(; i + 4 <= length; i += 4)
+    {
+        __m128i* pixels = (__m128i*)(row + i*4);
+        const __m128i value = _mm_loadu_si128(pixels);
+
+        __m128i low = _mm_unpacklo_epi8(value, zero),
+                high = _mm_unpackhi_epi8(value, zero);
+
+        low = divRound255(_mm_mullo_epi16(low, alphaFactors(low)));
+        high = divRound255(_mm_mullo_epi16(high, alphaFactors(high)));
+
+        _mm_storeu_si128(pixels, _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        uint8_t* pixel = row + i*4;
+        for(size_t c = 0; c < 3; ++c)
+        {
+            pixel[c] = divRound255(pixel[c]*pixel[3]);
+        }
+    }
+}
+
+static void coverageRow(uint8_t* row, const uint8_t* coverage, const size_t& length, const sf::Color& color)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i zero = _mm_setzero_si128(),
+                  full = _mm_set1_epi16(255),
+                  colors = _mm_setr_epi16(color.r, color.g, color.b, color.a,
+                                          color.r, color.g, color.b, color.a);
+    for(; i + 4 <= length; i += 4)
+    {
+        int32_t weights;
+        memcpy(&weights, coverage + i, 4);
+        if(!weights) continue;
+
+        // Repeat each pixel's coverage across its four channels
+
+        __m128i spread = _mm_cvtsi32_si128(weights);
+        spread = _mm_unpacklo_epi8(spread, spread);
+        spread = _mm_unpacklo_epi8(spread, spread);
+
+        __m128i* pixels = (__m128i*)(row + i*4);
+        const __m128i value = _mm_loadu_si128(pixels);
+
+        __m128i result[2];
+        for(size_t h = 0; h < 2; ++h)
+        {
+            const __m128i w = h ? _mm_unpackhi_epi8(spread, zero) : _mm_unpacklo_epi8(spread, zero),
+                          d = h ? _mm_unpackhi_epi8(value, zero) : _mm_unpacklo_epi8(value, zero);
+
+            result[h] = divRound255(_mm_add_epi16(_mm_mullo_epi16(colors, w),
+                                                  _mm_mullo_epi16(d, _mm_sub_epi16(full, w))));
+        }
+
+        _mm_storeu_si128(pixels, _mm_packus_epi16(result[0], result[1]));
+    }
+#endif
+
+    const uint8_t channels[4] = { color.r, color.g, color.b, color.a };
+    for(; i < length; ++i)
+    {
+        const unsigned int w = coverage[i];
+        if(!w) continue;
+
+        uint8_t* pixel = row + i*4;
+        for(size_t c = 0; c < 4; ++c)
+        {
+            pixel[c] = divRound255(channels[c]*w + pixel[c]*(255 - w));
+        }
+    }
+}
+
+static void blendRow(uint8_t* row, const uint8_t* source, const size_t& length)
+{
+    size_t i = 0;
+
+#ifdef CV_IMAGEOPS_SSE2
+    const __m128i zero = _mm_setzero_si128(),
+                  full = _mm_set1_epi16(255);
+    for(; i + 4 <= length; i += 4)
+    {
+        __m128i* pixels = (__m128i*)(row + i*4);
+        const __m128i src = _mm_loadu_si128((const __m128i*)(source + i*4)),
+                      dst = _mm_loadu_si128(pixels);
+
+        __m128i result[2];
+        for(size_t h = 0; h < 2; ++h)
+        {
+            const __m128i s = h ? _mm_unpackhi_epi8(src, zero) : _mm_unpacklo_epi8(src, zero),
+                          d = h ? _mm_unpackhi_epi8(dst, zero) : _mm_unpacklo_epi8(dst, zero),
+                          sourceFactors = alphaFactors(s),
+                          destFactors = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3,3,3,3)),
+                                                                                _MM_SHUFFLE(3,3,3,3)));
+
+            result[h] = divFloor255(_mm_add_epi16(_mm_mullo_epi16(s, sourceFactors),
+                                                  _mm_mullo_epi16(d, destFactors)));
+        }
+
+        _mm_storeu_si128(pixels, _mm_packus_epi16(result[0], result[1]));
+    }
+#endif
+
+    for(; i < length; ++i)
+    {
+        const uint8_t* src = source + i*4;
+        uint8_t* dst = row + i*4;
+        const unsigned int alpha = src[3];
+
+        for(size_t c = 0; c < 3; ++c)
+        {
+            dst[c] = divFloor255(src[c]*alpha + dst[c]*(255 - alpha));
+        }
+        dst[3] = alpha + divFloor255(dst[3]*(255 - alpha));
+    }
+}
+
+void fill(CVImageSpan image,
+          const sf::Color& color,
+          CVThreadPool* pool)
+{
+    const uint32_t value = packColor(color);
+    forEachRow(image, pool, [&](uint8_t* row, const size_t&)
+    {
+        fillRow(row, image.width, value);
+    });
+}
+
+void recolor(CVImageSpan image,
+             const sf::Color& color,
+             CVThreadPool* pool)
+{
+    const uint32_t value = packColor(sf::Color(color.r, color.g, color.b, 0)),
+                   alphaMask = packColor(sf::Color(0, 0, 0, 255));
+
+    forEachRow(image, pool, [&](uint8_t* row, const size_t&)
+    {
+        recolorRow(row, image.width, value, alphaMask);
+    });
+}
+
+void tint(CVImageSpan image,
+          const sf::Color& color,
+          CVThreadPool* pool)
+{
+    if(color == sf::Color::White) return;
+
+    forEachRow(image, pool, [&](uint8_t* row, const size_t&)
+    {
+        tintRow(row, image.width, color);
+    });
+}
+
+void premultiplyAlpha(CVImageSpan image,
+                      CVThreadPool* pool)
+{
+    forEachRow(image, pool, [&](uint8_t* row, const size_t&)
+    {
+        premultiplyRow(row, image.width);
+    });
+}
+
+void fillCoverage(CVImageSpan image,
+                  const uint8_t* coverage,
+                  const size_t& coverageStride,
+                  const sf::Color& color,
+                  CVThreadPool* pool)
+{
+    forEachRow(image, pool, [&](uint8_t* row, const size_t& y)
+    {
+        coverageRow(row, coverage + y*coverageStride, image.width, color);
+    });
+}
+
+void blit(CVImageSpan image,
+          const CVImageSpan& source,
+          const int& x,
+          const int& y,
+          const bool& blend,
+          CVThreadPool* pool)
+{
+    const CVImageSpan target = image.clip(sf::IntRect(x, y, source.width, source.height));
+    const unsigned int sourceX = max(-x, 0),
+                       sourceY = max(-y, 0);
+
+    forEachRow(target, pool, [&](uint8_t* row, const size_t& i)
+    {
+        const uint8_t* src = source.at(sourceX, sourceY + i);
+
+        if(blend) blendRow(row, src, target.width);
+        else memcpy(row, src, size_t(target.width)*4);
+    });
+}
+
+void expandCanvas(const CVImageSpan& source,
+                  CVImageSpan output,
+                  const sf::Vector2i& offset,
+                  const sf::Color& background,
+                  CVThreadPool* pool)
+{
+    const uint32_t value = packColor(background);
+
+    // Columns of output covered by the source
+
+    const size_t left = min<int64_t>(max(offset.x, 0), output.width),
+                 right = max<int64_t>(min<int64_t>(int64_t(offset.x) + source.width, output.width), left);
+
+    forEachRow(output, pool, [&](uint8_t* row, const size_t& y)
+    {
+        const int64_t sourceY = int64_t(y) - offset.y;
+
+        if((sourceY < 0) || (sourceY >= source.height) || (left == right))
+        {
+            fillRow(row, output.width, value);
+            return;
+        }
+
+        fillRow(row, left, value);
+        memcpy(row + left*4, source.at(left - offset.x, sourceY), (right - left)*4);
+        fillRow(row + right*4, output.width - right, value);
+    });
+}
+
+/** ========================================================================
+
+    Flood fill.  Pixels within the tolerance of the seed colour are inside
+    the region until painted.  When the fill colour is itself inside, a
+    bit per pixel records what has been painted.
+
+// ===================================================================== **/
+
+struct FloodRegion
+{
+    CVImageSpan image;
+    uint32_t seed;
+    uint8_t tolerance;
+    bool bTracked;
+    vector<uint64_t> painted;
+
+    FloodRegion(const CVImageSpan& image, const sf::Vector2i& seed, const unsigned int& tolerance):
+        image(image),
+        seed(pixel(seed.x, seed.y)),
+        tolerance(min(tolerance, 255u)),
+        bTracked(false) { }
+
+    inline bool matches(const uint32_t& pixel) const
+    {
+        if(pixel == seed) return true;
+        if(!tolerance) return false;
+
+        for(unsigned int shift = 0; shift < 32; shift += 8)
+        {
+            const int a = (pixel >> shift) & 0xFF,
+                      b = (seed >> shift) & 0xFF;
+            if(abs(a - b) > tolerance) return false;
+        }
+
+        return true;
+    }
+
+    inline uint32_t pixel(const unsigned int& x, const unsigned int& y) const
+    {
+        uint32_t value;
+        memcpy(&value, image.at(x, y), 4);
+        return value;
+    }
+
+    inline bool isPainted(const unsigned int& x, const unsigned int& y) const
+    {
+        const size_t i = size_t(y)*image.width + x;
+        return (painted[i >> 6] >> (i & 63)) & 1;
+    }
+
+    inline bool inside(const unsigned int& x, const unsigned int& y) const
+    {
+        return matches(pixel(x, y)) && !(bTracked && isPainted(x, y));
+    }
+
+#ifdef CV_IMAGEOPS_SSE2
+
+    inline static unsigned int lowestBit(int mask)
+    {
+        unsigned int i = 0;
+        for(; !(mask & 1); mask >>= 1) ++i;
+        return i;
+    }
+
+    // One bit per pixel of four which match the seed
+
+    inline int matchMask(const uint8_t* pixels) const
+    {
+        const __m128i value = _mm_loadu_si128((const __m128i*)pixels),
+                      seedValue = _mm_set1_epi32(int32_t(seed));
+
+        const __m128i difference = _mm_or_si128(_mm_subs_epu8(value, seedValue),
+                                                _mm_subs_epu8(seedValue, value));
+        const __m128i excess = _mm_subs_epu8(difference, _mm_set1_epi8(char(tolerance)));
+
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(excess, _mm_setzero_si128())));
+    }
+
+#endif
+
+    // First x in [x, end) of row y which is outside the region, or end
+
+    unsigned int runEnd(unsigned int x, const unsigned int& y, const unsigned int& end) const
+    {
+#ifdef CV_IMAGEOPS_SSE2
+        if(!bTracked)
+        {
+            for(; x + 4 <= end; x += 4)
+            {
+                const int mask = matchMask(image.at(x, y));
+                if(mask != 0xF) return x + lowestBit(~mask);
+            }
+        }
+#endif
+        while((x < end) && inside(x, y)) ++x;
+        return x;
+    }
+
+    // First x in [x, end) of row y which is inside the region, or end
+
+    unsigned int runStart(unsigned int x, const unsigned int& y, const unsigned int& end) const
+    {
+#ifdef CV_IMAGEOPS_SSE2
+        if(!bTracked)
+        {
+            for(; x + 4 <= end; x += 4)
+            {
+                const int mask = matchMask(image.at(x, y));
+                if(mask) return x + lowestBit(mask);
+            }
+        }
+#endif
+        while((x < end) && !inside(x, y)) ++x;
+        return x;
+    }
+
+    void paint(const unsigned int& left, const unsigned int& right, const unsigned int& y, const uint32_t& value)
+    {
+        fillRow(image.at(left, y), right - left, value);
+
+        if(bTracked)
+        {
+            for(size_t i = size_t(y)*image.width + left, end = size_t(y)*image.width + right; i < end; ++i)
+            {
+                painted[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+        }
+    }
+};
+
+sf::IntRect floodFill(CVImageSpan image,
+                      const sf::Vector2i& seed,
+                      const sf::Color& color,
+                      const unsigned int& tolerance,
+                      const bool& diagonal)
+{
+    if((seed.x < 0) || (seed.y < 0) ||
+       (seed.x >= int(image.width)) || (seed.y >= int(image.height))) return sf::IntRect();
+
+    FloodRegion region(image, seed, tolerance);
+    const uint32_t value = packColor(color);
+
+    region.bTracked = region.matches(value);
+    if(region.bTracked)
+    {
+        if(!region.tolerance) return sf::IntRect(); // Already the fill colour
+        region.painted.assign((size_t(image.width)*image.height + 63)/64, 0);
+    }
+
+    const unsigned int W = image.width,
+                       H = image.height,
+                       reach = diagonal ? 1 : 0;
+
+    unsigned int left = W, top = H, right = 0, bottom = 0;
+
+    // Each entry scans row y beside a filled run [left, right) of row y - dy.
+    // Rows are only scanned back toward the parent where a run overhangs it
+
+    struct Span
+    {
+        unsigned int left, right, y;
+        int dy;
+    };
+
+    vector<Span> spans;
+
+    auto fillRun = [&](const unsigned int& runLeft, const unsigned int& runRight, const unsigned int& y)
+    {
+        region.paint(runLeft, runRight, y, value);
+
+        left = min(left, runLeft);
+        right = max(right, runRight);
+        top = min(top, y);
+        bottom = max(bottom, y + 1);
+    };
+
+    auto queue = [&](const unsigned int& runLeft, const unsigned int& runRight, const unsigned int& y, const int& dy)
+    {
+        if(((dy < 0) && !y) || ((dy > 0) && (y + 1 >= H))) return;
+        spans.push_back({ runLeft, runRight, y + dy, dy });
+    };
+
+    unsigned int seedLeft = seed.x;
+    while((seedLeft > 0) && region.inside(seedLeft - 1, seed.y)) --seedLeft;
+
+    const unsigned int seedRight = region.runEnd(seed.x + 1, seed.y, W);
+
+    fillRun(seedLeft, seedRight, seed.y);
+    queue(seedLeft, seedRight, seed.y, 1);
+    queue(seedLeft, seedRight, seed.y, -1);
+
+    while(!spans.empty())
+    {
+        const Span span = spans.back();
+        spans.pop_back();
+
+        const unsigned int scanLeft = span.left >= reach ? span.left - reach : 0,
+                           scanRight = min(span.right + reach, W);
+
+        for(unsigned int x = region.runStart(scanLeft, span.y, scanRight); x < scanRight;
+            x = region.runStart(x, span.y, scanRight))
+        {
+            unsigned int runLeft = x;
+            if(x == scanLeft)
+            {
+                while((runLeft > 0) && region.inside(runLeft - 1, span.y)) --runLeft;
+            }
+
+            x = region.runEnd(x + 1, span.y, W);
+
+            fillRun(runLeft, x, span.y);
+            queue(runLeft, x, span.y, span.dy);
+
+            if((runLeft < span.left) || (x > span.right))
+            {
+                queue(runLeft, x, span.y, -span.dy);
+            }
+        }
+    }
+
+    if(right <= left) return sf::IntRect();
+    return sf::IntRect(left, top, right - left, bottom - top);
+}
+
+}
@@ -42,9 +42,19 @@
 /////////////////////////////////////////////////////////////  **/
 
 #include "cvision/import.hpp"
+#include "cvision/assetpack.hpp"
+
+#include <SFML/OpenGL.hpp>
+
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D    // OpenGL 1.2, missing from some platform headers
+#endif
 
 #include <iostream>
+#include <fstream>
+#include <cstring>
 #include <stdexcept>
+#include <iterator>
 
 using namespace std;
 
@@ -95,6 +105,45 @@ bool FontManager::addFont(const void* binaries, const size_t& size, const string
     return true;
 }
 
+bool FontManager::addFont(sf::Font* font, const string& tag)
+{
+    if(!font) return false;
+
+    if(fonts.find(tag) != fonts.end())
+    {
+        cout << "Warning: request to add redundant font tag \"" << tag << "\" was ignored\n";
+        delete(font);
+        return false;
+    }
+
+    fonts.emplace(tag, font);
+    return true;
+}
+
+size_t FontManager::addPack(const std::shared_ptr<const CVAssetPack>& pack)
+{
+    if(!pack || !pack->isOpen()) return 0;
+
+    size_t numAdded = 0;
+
+    for(size_t i = 0; i < pack->numFonts(); ++i)
+    {
+        sf::Font* font = new sf::Font();
+        if(!font->loadFromMemory(pack->fontData(i), pack->font(i).size))
+        {
+            cout << "Failed to load font: " << pack->fontTag(i) << '\n';
+            delete(font);
+            continue;
+        }
+
+        if(addFont(font, pack->fontTag(i))) ++numAdded;
+    }
+
+    if(numAdded) packs.push_back(pack);
+
+    return numAdded;
+}
+
 FontManager::~FontManager()
 {
     for(auto& pair : fonts)
@@ -103,83 +152,713 @@ FontManager::~FontManager()
     }
 }
 
-const sf::Texture* ImageManager::taggedTexture(const string& s) const
+constexpr unsigned int ImageManager::npos;
+
+unsigned int ImageManager::textureHandle(const string& tag) const
 {
-    if(s.size() < 1) return nullptr;
-    unsigned int index = 0;
-    for(auto& tag : textureTags)
+    lock_guard<mutex> lock(textureLock);
+
+    auto it = textureIndex.find(tag);
+    if(it == textureIndex.end()) return npos;
+    return it->second;
+}
+
+unsigned int ImageManager::textureHandle(const sf::Texture* texture) const
+{
+    lock_guard<mutex> lock(textureLock);
+    return findTexture(texture);
+}
+
+unsigned int ImageManager::imageHandle(const string& tag) const
+{
+    auto it = imageIndex.find(tag);
+    if(it == imageIndex.end()) return npos;
+    return it->second;
+}
+
+CVShelfPacker::CVShelfPacker(const unsigned int& pageSize,
+                             const unsigned int& padding,
+                             const unsigned int& alignment):
+    pageSize(pageSize),
+    padding(padding),
+    alignment(alignment ? alignment : 1)
+{
+
+}
+
+void CVShelfPacker::setPageSize(const unsigned int& newSize)
+{
+    pageSize = newSize;
+}
+
+void CVShelfPacker::clear()
+{
+    pages.clear();
+}
+
+bool CVShelfPacker::insert(const sf::Vector2u& size,
+                           unsigned int& page,
+                           sf::Vector2u& position)
+{
+    const unsigned int w = (size.x + padding + alignment - 1)/alignment*alignment,
+                       h = (size.y + padding + alignment - 1)/alignment*alignment;
+
+    if(!size.x || !size.y || (w > pageSize) || (h > pageSize)) return false;
+
+    Page* target = nullptr;
+    Shelf* shelf = nullptr;
+
+    // Prefer the existing shelf that wastes the least height
+
+    for(auto& p : pages)
     {
-        if(tag == s) return &textures[index];
-        ++index;
+        for(auto& s : p.shelves)
+        {
+            if((s.height >= h) && (s.width + w <= p.size) &&
+               (!shelf || (s.height < shelf->height)))
+            {
+                target = &p;
+                shelf = &s;
+            }
+        }
+    }
+
+    if(!shelf)
+    {
+        for(auto& p : pages)
+        {
+            if((p.height + h <= p.size) && (w <= p.size))
+            {
+                target = &p;
+                break;
+            }
+        }
+
+        if(!target)
+        {
+            pages.push_back({ pageSize, 0, std::vector<Shelf>() });
+            target = &pages.back();
+        }
+
+        target->shelves.push_back({ target->height, h, 0 });
+        target->height += h;
+        shelf = &target->shelves.back();
     }
-    return nullptr;
+
+    page = target - pages.data();
+    position.x = shelf->width;
+    position.y = shelf->top;
+
+    shelf->width += w;
+    return true;
+}
+
+const sf::Texture* ImageManager::taggedTexture(const string& s) const
+{
+    if(s.size() < 1) return nullptr;
+
+    lock_guard<mutex> lock(textureLock);
+
+    auto it = textureIndex.find(s);
+    if(it == textureIndex.end()) return nullptr;
+    return textures[it->second].get();
 }
 const sf::Image* ImageManager::taggedImage(const string& s) const
 {
     if(s.size() < 1) return nullptr;
-    unsigned int index = 0;
-    for(auto& tag : imageTags)
+    return indexImage(imageHandle(s));
+}
+
+string ImageManager::getTextureName(const sf::Texture* texture) const
+{
+    lock_guard<mutex> lock(textureLock);
+
+    unsigned int handle = findTexture(texture);
+    if(handle == npos) return string();
+    return textureTags[handle];
+}
+
+string ImageManager::getTextureName(const sf::Texture* texture, const sf::IntRect& rect) const
+{
+    lock_guard<mutex> lock(textureLock);
+
+    auto it = atlasTags.find(make_pair(texture, make_pair(rect.left, rect.top)));
+    if(it != atlasTags.end()) return textureTags[it->second];
+
+    // Sub-rects of a packed image start inside its region rather than at its origin
+
+    const sf::Vector2i corner(min(rect.left, rect.left + rect.width),
+                              min(rect.top, rect.top + rect.height));
+
+    for(it = atlasTags.lower_bound(make_pair(texture, make_pair(INT_MIN, INT_MIN)));
+        (it != atlasTags.end()) && (it->first.first == texture); ++it)
     {
-        if(tag == s) return &images[index];
-        ++index;
+        if(atlasRegions[it->second].rect.contains(corner)) return textureTags[it->second];
     }
-    return nullptr;
+
+    unsigned int handle = findTexture(texture);
+    if(handle == npos) return string();
+    return textureTags[handle];
 }
 
-string ImageManager::getTextureName(const sf::Texture* texture) const
+void ImageManager::setAtlasMode(const bool& state,
+                                const unsigned int& pageSize,
+                                const unsigned int& maxItemSize)
+{
+    bAtlas = state;
+
+    unsigned int atlasPageSize = pageSize;
+    unsigned int maxSize = sf::Texture::getMaximumSize();
+    if(maxSize && (atlasPageSize > maxSize))
+    {
+        cout << "Warning (CVision): atlas page size " << pageSize
+             << " exceeds the maximum texture size and was reduced to " << maxSize << '\n';
+        atlasPageSize = maxSize;
+    }
+
+    atlasPacker.setPageSize(atlasPageSize);
+    atlasMaxItemSize = maxItemSize < atlasPageSize ? maxItemSize : atlasPageSize;
+}
+
+CVTextureRegion ImageManager::textureRegion(const string& tag) const
+{
+    return textureRegion(taggedTexture(tag));
+}
+
+CVTextureRegion ImageManager::textureRegion(const sf::Texture* texture) const
+{
+    lock_guard<mutex> lock(textureLock);
+    return findRegion(texture);
+}
+
+CVTextureRegion ImageManager::findRegion(const sf::Texture* texture) const
 {
-    for(size_t i = 0; i < numTextures; ++i)
+    if(!texture) return { nullptr, sf::IntRect() };
+
+    unsigned int handle = findTexture(texture);
+    if(handle != npos)
     {
-        if(&textures[i] == texture) return textureTags[i];
+        if(atlasRegions[handle].texture) return atlasRegions[handle];
+
+        auto lazy = lazyTextures.find(handle);
+        if(lazy != lazyTextures.end())
+        {
+            return { texture, sf::IntRect(0, 0, lazy->second.imageSize.x, lazy->second.imageSize.y) };
+        }
+    }
+
+    return { texture, sf::IntRect(0, 0, texture->getSize().x, texture->getSize().y) };
+}
+
+// Stop sampling below [level], which the atlas padding no longer covers
+
+static void setMaxMipLevel(sf::Texture& texture, const unsigned int& level)
+{
+    sf::Context context;    // SFML only holds a context during its own calls
+
+    sf::Texture::bind(&texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+    sf::Texture::bind(nullptr);
+}
+
+bool ImageManager::packTexture(const sf::Image& image)
+{
+    atlasRegions.push_back({ nullptr, sf::IntRect() });
+
+    const sf::Vector2u size = image.getSize();
+    if(!bAtlas ||
+       !size.x || !size.y ||
+       (size.x > atlasMaxItemSize) ||
+       (size.y > atlasMaxItemSize)) return false;
+
+    unsigned int page;
+    sf::Vector2u position;
+
+    if(!atlasPacker.insert(size, page, position)) return false;
+
+    while(atlasPages.size() <= page)
+    {
+        const unsigned int pageSize = atlasPacker.getPageSize(atlasPages.size());
+
+        sf::Image blank;
+        blank.create(pageSize, pageSize, sf::Color::Transparent);
+
+        atlasPages.emplace_back(new sf::Texture());
+        if(!atlasPages.back()->loadFromImage(blank))
+        {
+            cout << "Warning (CVision): failed to create texture atlas page\n";
+        }
+
+        atlasPages.back()->setSmooth(true);
+        setMaxMipLevel(*atlasPages.back(), CV_ATLAS_MIP_LEVELS);
     }
-    return string();
+
+    atlasPages[page]->update(image, position.x, position.y);
+    atlasPages[page]->generateMipmap();    // Updates drop the page's mip levels
+
+    CVTextureRegion& region = atlasRegions.back();
+    region.texture = atlasPages[page].get();
+    region.rect = sf::IntRect(position.x, position.y, size.x, size.y);
+
+    atlasTags[make_pair(region.texture, make_pair(region.rect.left, region.rect.top))] = numTextures;
+    return true;
 }
 
 bool ImageManager::addImage(string fileName, string tag)
 {
-    images.emplace_back();
-    if(!images.back().loadFromFile(fileName))
+    std::unique_ptr<sf::Image> image(new sf::Image());
+    if(!image->loadFromFile(fileName))
     {
-        images.pop_back();
         cout << "Failed to load image: " << tag << '\n';
         return false;
     }
+    return addImage(std::move(image), tag);
+}
+
+bool ImageManager::addImage(std::unique_ptr<sf::Image> image, const string& tag)
+{
+    if(!image) return false;
+    imageIndex.emplace(tag, numImages);
     imageTags.push_back(tag);
+    images.emplace_back(std::move(image));
     ++numImages;
     return true;
 }
 
+void ImageManager::registerTexture(std::unique_ptr<sf::Texture>& texture, const string& tag)
+{
+    textureHandles[texture.get()] = numTextures;
+    textureIndex.emplace(tag, numTextures);
+    textureTags.push_back(tag);
+    textures.emplace_back(std::move(texture));
+    ++numTextures;
+}
+
 bool ImageManager::addTexture(string fileName, string tag)
 {
 
-    textures.emplace_back();
-    if(!textures.back().loadFromFile(fileName))
+    sf::Image image;
+    if(!image.loadFromFile(fileName)) return false;
+    return addTexture(image, tag);
+}
+
+bool ImageManager::addTexture(const void* binaries, const size_t& size,
+                              const string& tag)
+{
+    sf::Image image;
+    if(!image.loadFromMemory(binaries, size)) return false;
+    return addTexture(image, tag);
+}
+
+bool ImageManager::addTexture(const sf::Image& image, const string& tag)
+{
+    std::unique_ptr<sf::Texture> texture(new sf::Texture());
+    if(!texture->loadFromImage(image)) return false;
+
+    lock_guard<mutex> lock(textureLock);
+
+    texture->setSmooth(true);
+    if(!packTexture(image)) texture->generateMipmap();  // Packed sprites are minified through the page
+    registerTexture(texture, tag);
+    return true;
+}
+
+// Upload the precomputed mip levels of a pack page.  SFML has no interface
+// for this, so the levels go straight to GL once the texture is smooth,
+// since setSmooth() would otherwise reset the minification filter.  Packs
+// are usually loaded before any window is open, and bind() only holds a
+// context for the duration of its own call, so keep one of our own.
+
+static void uploadPackLevels(const CVAssetPack& pack, const size_t& index, sf::Texture& texture)
+{
+    sf::Context context;
+
+    sf::Texture::bind(&texture);
+
+    for(unsigned int level = 1; level < pack.page(index).levels; ++level)
+    {
+        const sf::Vector2u size = pack.pageLevelSize(index, level);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, size.x, size.y, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, pack.pagePixels(index, level));
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, pack.page(index).levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+    sf::Texture::bind(nullptr);
+}
+
+size_t ImageManager::addPack(const CVAssetPack& pack)
+{
+    if(!pack.isOpen()) return 0;
+
+    std::vector<std::unique_ptr<sf::Texture>> pageTextures(pack.numPages());
+
+    for(size_t i = 0; i < pack.numPages(); ++i)
+    {
+        const CVPackPage& page = pack.page(i);
+
+        pageTextures[i].reset(new sf::Texture());
+        if(!pageTextures[i]->create(page.width, page.height))
+        {
+            cout << "Warning (CVision): failed to create texture for asset pack page " << i << '\n';
+            pageTextures[i].reset();
+            continue;
+        }
+
+        pageTextures[i]->update(pack.pagePixels(i));
+        pageTextures[i]->setSmooth(true);
+
+        if(page.levels > 1) uploadPackLevels(pack, i, *pageTextures[i]);
+        else
+        {
+            if(!(page.flags & CV_PACK_PAGE_STANDALONE)) setMaxMipLevel(*pageTextures[i], CV_ATLAS_MIP_LEVELS);
+            pageTextures[i]->generateMipmap();
+        }
+    }
+
+    size_t numAdded = 0;
+    std::vector<uint8_t> pixels;
+
+    lock_guard<mutex> lock(textureLock);
+
+    for(size_t i = 0; i < pack.numImages(); ++i)
+    {
+        const CVPackImage& image = pack.image(i);
+        const CVPackPage& page = pack.page(image.page);
+
+        if(!pageTextures[image.page]) continue; // Failed, or a standalone page already claimed
+
+        if(page.flags & CV_PACK_PAGE_STANDALONE)
+        {
+            atlasRegions.push_back({ nullptr, sf::IntRect() });
+            registerTexture(pageTextures[image.page], pack.imageTag(i));
+        }
+        else
+        {
+            // Keep a texture of its own as well, for callers which need the whole texture.
+            // Sprites are drawn from the page, which holds the mip levels
+
+            const uint8_t* source = pack.pagePixels(image.page);
+            pixels.resize(size_t(image.width)*image.height*4);
+
+            for(int y = 0; y < image.height; ++y)
+            {
+                memcpy(&pixels[size_t(y)*image.width*4],
+                       source + (size_t(image.top + y)*page.width + image.left)*4,
+                       size_t(image.width)*4);
+            }
+
+            std::unique_ptr<sf::Texture> texture(new sf::Texture());
+            if(!texture->create(image.width, image.height)) continue;
+
+            texture->update(pixels.data());
+            texture->setSmooth(true);
+
+            const sf::Texture* pageTexture = pageTextures[image.page].get();
+            atlasRegions.push_back({ pageTexture, sf::IntRect(image.left, image.top, image.width, image.height) });
+            atlasTags[make_pair(pageTexture, make_pair(image.left, image.top))] = numTextures;
+
+            registerTexture(texture, pack.imageTag(i));
+        }
+
+        ++numAdded;
+    }
+
+    for(auto& texture : pageTextures)
+    {
+        if(texture) packPages.emplace_back(std::move(texture)); // Shared pages
+    }
+
+    return numAdded;
+}
+
+// Pixel size from the header of an encoded image, for the formats which
+// keep it there.  False if the format is not recognised or is truncated
+
+static uint32_t readBE16(const uint8_t* data){ return (uint32_t(data[0]) << 8) | data[1]; }
+static uint32_t readLE16(const uint8_t* data){ return (uint32_t(data[1]) << 8) | data[0]; }
+static uint32_t readBE32(const uint8_t* data){ return (readBE16(data) << 16) | readBE16(data + 2); }
+static uint32_t readLE32(const uint8_t* data){ return (readLE16(data + 2) << 16) | readLE16(data); }
+
+static bool readJpegSize(const uint8_t* data, const size_t& size, sf::Vector2u& imageSize)
+{
+    size_t i = 2;   // Past the SOI marker
+
+    while(i + 4 <= size)
+    {
+        if(data[i] != 0xFF) return false;
+
+        const uint8_t marker = data[i + 1];
+
+        if(marker == 0xFF)
+        {
+            ++i;    // Fill byte
+            continue;
+        }
+        if((marker == 0x01) || ((marker >= 0xD0) && (marker <= 0xD8)))
+        {
+            i += 2; // No length field
+            continue;
+        }
+        if((marker == 0xD9) || (marker == 0xDA)) return false; // Scan data before any frame header
+
+        if((marker >= 0xC0) && (marker <= 0xCF) &&
+           (marker != 0xC4) && (marker != 0xC8) && (marker != 0xCC))
+        {
+            if(i + 9 > size) return false;
+            imageSize = sf::Vector2u(readBE16(data + i + 7), readBE16(data + i + 5));
+            return true;
+        }
+
+        i += 2 + readBE16(data + i + 2);
+    }
+
+    return false;
+}
+
+static bool readImageSize(const uint8_t* data, const size_t& size, sf::Vector2u& imageSize)
+{
+    static const uint8_t pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    imageSize = sf::Vector2u(0, 0);
+
+    if((size >= 24) && !memcmp(data, pngSignature, 8) && !memcmp(data + 12, "IHDR", 4))
+    {
+        imageSize = sf::Vector2u(readBE32(data + 16), readBE32(data + 20));
+    }
+    else if((size >= 10) && (!memcmp(data, "GIF87a", 6) || !memcmp(data, "GIF89a", 6)))
+    {
+        imageSize = sf::Vector2u(readLE16(data + 6), readLE16(data + 8));
+    }
+    else if((size >= 26) && !memcmp(data, "BM", 2))
+    {
+        if(readLE32(data + 14) == 12)    // OS/2 core header
+        {
+            imageSize = sf::Vector2u(readLE16(data + 18), readLE16(data + 20));
+        }
+        else
+        {
+            uint32_t height = readLE32(data + 22);
+            if(height & 0x80000000u) height = 0u - height;  // Top-down rows
+            imageSize = sf::Vector2u(readLE32(data + 18), height);
+        }
+    }
+    else if((size >= 26) && !memcmp(data, "8BPS", 4))
+    {
+        imageSize = sf::Vector2u(readBE32(data + 18), readBE32(data + 14));
+    }
+    else if((size >= 4) && (data[0] == 0xFF) && (data[1] == 0xD8))
+    {
+        if(!readJpegSize(data, size, imageSize)) return false;
+    }
+
+    return imageSize.x && imageSize.y;
+}
+
+// Size of a lazy texture source, decoding it only if the header cannot be read
+
+static bool probeImageSize(const string& fileName, sf::Vector2u& imageSize)
+{
+    ifstream input(fileName, ios::binary);
+
+    vector<uint8_t> data(1 << 16);
+    input.read((char*)data.data(), data.size());
+    data.resize(input.gcount());
+
+    if(readImageSize(data.data(), data.size(), imageSize)) return true;
+
+    if(input.good())    // Metadata can push a JPEG frame header past the first read
+    {
+        data.insert(data.end(), istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+        if(readImageSize(data.data(), data.size(), imageSize)) return true;
+    }
+
+    sf::Image image;
+    if(!image.loadFromMemory(data.data(), data.size())) return false;
+    imageSize = image.getSize();
+    return true;
+}
+
+static bool probeImageSize(const void* binaries, const size_t& size, sf::Vector2u& imageSize)
+{
+    if(readImageSize((const uint8_t*)binaries, size, imageSize)) return true;
+
+    sf::Image image;
+    if(!image.loadFromMemory(binaries, size)) return false;
+    imageSize = image.getSize();
+    return true;
+}
+
+bool ImageManager::addLazyTexture(const string& fileName, const string& tag)
+{
+    if(!ifstream(fileName).good())
     {
-        textures.pop_back();
+        cout << "Warning (CVision): lazy texture source \"" << fileName << "\" could not be opened\n";
         return false;
     }
 
-    textures.back().setSmooth(true);
-    textures.back().generateMipmap();
-    textureTags.push_back(tag);
-    ++numTextures;
+    sf::Vector2u imageSize;
+    if(!probeImageSize(fileName, imageSize))
+    {
+        cout << "Warning (CVision): lazy texture source \"" << fileName << "\" is not a readable image\n";
+        return false;
+    }
+
+    std::unique_ptr<sf::Texture> texture(new sf::Texture());
+
+    lock_guard<mutex> lock(textureLock);
+
+    unsigned int handle = numTextures;
+    packTexture(sf::Image());   // Lazy textures are never packed, but keep the regions aligned
+    registerTexture(texture, tag);
+
+    lazyTextures.emplace(handle, LazyTexture{ fileName, nullptr, 0, imageSize, false, 0,
+                                              chrono::steady_clock::time_point(), lazyLRU.end() });
+    ++numLazy;
     return true;
 }
+
+bool ImageManager::addLazyTexture(const void* binaries, const size_t& size,
+                                  const string& tag)
+{
+    if(!binaries || !size) return false;
 
-bool ImageManager::addTexture(const void* binaries, const size_t& size,
-                              const string& tag)
+    sf::Vector2u imageSize;
+    if(!probeImageSize(binaries, size, imageSize))
+    {
+        cout << "Warning (CVision): lazy texture \"" << tag << "\" is not a readable image\n";
+        return false;
+    }
+
+    std::unique_ptr<sf::Texture> texture(new sf::Texture());
+
+    lock_guard<mutex> lock(textureLock);
+
+    unsigned int handle = numTextures;
+    packTexture(sf::Image());
+    registerTexture(texture, tag);
+
+    lazyTextures.emplace(handle, LazyTexture{ string(), binaries, size, imageSize, false, 0,
+                                              chrono::steady_clock::time_point(), lazyLRU.end() });
+    ++numLazy;
+    return true;
+}
+
+bool ImageManager::decodeLazy(const unsigned int& handle, LazyTexture& lazy)
 {
-    textures.emplace_back();
-    if(!textures.back().loadFromMemory(binaries, size))
+    if(!lazy.binaries && lazy.fileName.empty()) return false; // Failed before
+
+    sf::Texture& texture = *textures[handle];
+
+    if(!(lazy.binaries ? texture.loadFromMemory(lazy.binaries, lazy.size) :
+                         texture.loadFromFile(lazy.fileName)))
     {
-        textures.pop_back();
+        cout << "Warning (CVision): failed to decode lazy texture \"" << textureTags[handle] << "\"\n";
+        lazy.fileName.clear();
+        lazy.binaries = nullptr;
+        ++cacheStats.failures;
         return false;
     }
-    textures.back().setSmooth(true);
-    textures.back().generateMipmap();
-    textureTags.push_back(tag);
-    ++numTextures;
+
+    texture.setSmooth(true);
+    texture.generateMipmap();
+
+    const sf::Vector2u texSize = texture.getSize();
+    lazy.imageSize = texSize;
+    lazy.bytes = size_t(texSize.x)*texSize.y*16/3; // RGBA plus a third for mipmaps
+    lazy.bResident = true;
+
+    lazyLRU.push_front(handle);
+    lazy.lruPos = lazyLRU.begin();
+
+    cacheStats.residentBytes += lazy.bytes;
     return true;
 }
 
+void ImageManager::evictLazy(const unsigned int& handle, LazyTexture& lazy)
+{
+    sf::Texture().swap(*textures[handle]);
+
+    lazyLRU.erase(lazy.lruPos);
+    lazy.lruPos = lazyLRU.end();
+    lazy.bResident = false;
+
+    cacheStats.residentBytes -= lazy.bytes;
+    ++cacheStats.evictions;
+}
+
+void ImageManager::trimLazy()
+{
+    if(!cacheStats.budgetBytes) return;
+
+    const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    while((cacheStats.residentBytes > cacheStats.budgetBytes) && !lazyLRU.empty())
+    {
+        const unsigned int handle = lazyLRU.back();
+        LazyTexture& lazy = lazyTextures.at(handle);
+
+        if(now - lazy.lastUse < evictionDelay) break; // Everything left is in use
+
+        evictLazy(handle, lazy);
+    }
+}
+
+void ImageManager::touch(const sf::Texture* texture)
+{
+    if(!texture || !numLazy) return;
+
+    lock_guard<mutex> lock(textureLock);
+
+    const unsigned int handle = findTexture(texture);
+    if(handle == npos) return;
+
+    auto it = lazyTextures.find(handle);
+    if(it == lazyTextures.end()) return;
+
+    LazyTexture& lazy = it->second;
+    lazy.lastUse = chrono::steady_clock::now();
+
+    if(lazy.bResident)
+    {
+        ++cacheStats.hits;
+        lazyLRU.splice(lazyLRU.begin(), lazyLRU, lazy.lruPos);
+        return;
+    }
+
+    if(!decodeLazy(handle, lazy)) return;
+
+    ++cacheStats.misses;
+    trimLazy();
+}
+
+void ImageManager::setTextureBudget(const size_t& bytes)
+{
+    lock_guard<mutex> lock(textureLock);
+    cacheStats.budgetBytes = bytes;
+    trimLazy();
+}
+
+void ImageManager::setEvictionDelay(const float& seconds)
+{
+    lock_guard<mutex> lock(textureLock);
+    evictionDelay = chrono::duration<float>(seconds);
+}
+
+CVTextureCacheStats ImageManager::textureCacheStats()
+{
+    lock_guard<mutex> lock(textureLock);
+    return cacheStats;
+}
+
+void ImageManager::resetTextureCacheStats()
+{
+    lock_guard<mutex> lock(textureLock);
+    cacheStats.hits = 0;
+    cacheStats.misses = 0;
+    cacheStats.evictions = 0;
+    cacheStats.failures = 0;
+}
+
 }
@@ -0,0 +1,548 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/input.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace cvis
+{
+
+namespace
+{
+
+// Binary recording layout (little-endian):
+//   "CVIQ" u32:version u32:frameCount
+//   per frame:  u64:time f32:frameTime i32[4]:mouse, global mouse u8:focus u32:eventCount
+//   per event:  u32:time offset from the frame u8:type, then a type-dependent payload
+
+const char          CV_INPUT_MAGIC[4]       = { 'C', 'V', 'I', 'Q' };
+const uint32_t      CV_INPUT_VERSION        = 1;
+
+template<typename T> void writeValue(ostream& output, const T& value)
+{
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+
+    #if defined __BYTE_ORDER__ && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    for(size_t i = 0; i < sizeof(T)/2; ++i)    // Stored little-endian regardless of the host
+    {
+        swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+    #endif
+
+    output.write((const char*)bytes, sizeof(T));
+}
+
+template<typename T> bool readValue(istream& input, T& value)
+{
+    unsigned char bytes[sizeof(T)];
+    if(!input.read((char*)bytes, sizeof(T))) return false;
+
+    #if defined __BYTE_ORDER__ && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    for(size_t i = 0; i < sizeof(T)/2; ++i)
+    {
+        swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+    #endif
+
+    memcpy(&value, bytes, sizeof(T));
+    return true;
+}
+
+bool recordable(const sf::Event::EventType& type)
+{
+    switch(type)
+    {
+        case sf::Event::Closed:
+        case sf::Event::Resized:
+        case sf::Event::LostFocus:
+        case sf::Event::GainedFocus:
+        case sf::Event::TextEntered:
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+        case sf::Event::MouseWheelMoved:
+        case sf::Event::MouseWheelScrolled:
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+        case sf::Event::MouseMoved:
+        case sf::Event::MouseEntered:
+        case sf::Event::MouseLeft:
+            return true;
+        default:
+            return false;   // Joystick, touch and sensor input is not recorded
+    }
+}
+
+void writeEvent(ostream& output, const sf::Event& event)
+{
+
+    writeValue<uint8_t>(output, event.type);
+
+    switch(event.type)
+    {
+        case sf::Event::Resized:
+        {
+            writeValue<uint32_t>(output, event.size.width);
+            writeValue<uint32_t>(output, event.size.height);
+            break;
+        }
+        case sf::Event::TextEntered:
+        {
+            writeValue<uint32_t>(output, event.text.unicode);
+            break;
+        }
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+        {
+            writeValue<int32_t>(output, event.key.code);
+            writeValue<uint8_t>(output, (event.key.alt ? 1 : 0) |
+                                        (event.key.control ? 2 : 0) |
+                                        (event.key.shift ? 4 : 0) |
+                                        (event.key.system ? 8 : 0));
+            break;
+        }
+        case sf::Event::MouseWheelMoved:
+        {
+            writeValue<int32_t>(output, event.mouseWheel.delta);
+            writeValue<int32_t>(output, event.mouseWheel.x);
+            writeValue<int32_t>(output, event.mouseWheel.y);
+            break;
+        }
+        case sf::Event::MouseWheelScrolled:
+        {
+            writeValue<uint8_t>(output, event.mouseWheelScroll.wheel);
+            writeValue<float>(output, event.mouseWheelScroll.delta);
+            writeValue<int32_t>(output, event.mouseWheelScroll.x);
+            writeValue<int32_t>(output, event.mouseWheelScroll.y);
+            break;
+        }
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+        {
+            writeValue<uint8_t>(output, event.mouseButton.button);
+            writeValue<int32_t>(output, event.mouseButton.x);
+            writeValue<int32_t>(output, event.mouseButton.y);
+            break;
+        }
+        case sf::Event::MouseMoved:
+        {
+            writeValue<int32_t>(output, event.mouseMove.x);
+            writeValue<int32_t>(output, event.mouseMove.y);
+            break;
+        }
+        default: break;
+    }
+
+}
+
+bool readEvent(istream& input, sf::Event& event)
+{
+
+    uint8_t type;
+    if(!readValue(input, type)) return false;
+
+    event.type = (sf::Event::EventType)type;
+    if(!recordable(event.type)) return false;
+
+    switch(event.type)
+    {
+        case sf::Event::Resized:
+        {
+            uint32_t width, height;
+            if(!readValue(input, width) || !readValue(input, height)) return false;
+            event.size.width = width;
+            event.size.height = height;
+            break;
+        }
+        case sf::Event::TextEntered:
+        {
+            uint32_t unicode;
+            if(!readValue(input, unicode)) return false;
+            event.text.unicode = unicode;
+            break;
+        }
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+        {
+            int32_t code;
+            uint8_t modifiers;
+            if(!readValue(input, code) || !readValue(input, modifiers)) return false;
+            event.key.code = (sf::Keyboard::Key)code;
+            event.key.alt = modifiers & 1;
+            event.key.control = modifiers & 2;
+            event.key.shift = modifiers & 4;
+            event.key.system = modifiers & 8;
+            break;
+        }
+        case sf::Event::MouseWheelMoved:
+        {
+            int32_t delta, x, y;
+            if(!readValue(input, delta) || !readValue(input, x) || !readValue(input, y)) return false;
+            event.mouseWheel.delta = delta;
+            event.mouseWheel.x = x;
+            event.mouseWheel.y = y;
+            break;
+        }
+        case sf::Event::MouseWheelScrolled:
+        {
+            uint8_t wheel;
+            float delta;
+            int32_t x, y;
+            if(!readValue(input, wheel) || !readValue(input, delta) ||
+               !readValue(input, x) || !readValue(input, y)) return false;
+            event.mouseWheelScroll.wheel = (sf::Mouse::Wheel)wheel;
+            event.mouseWheelScroll.delta = delta;
+            event.mouseWheelScroll.x = x;
+            event.mouseWheelScroll.y = y;
+            break;
+        }
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+        {
+            uint8_t button;
+            int32_t x, y;
+            if(!readValue(input, button) || !readValue(input, x) || !readValue(input, y)) return false;
+            event.mouseButton.button = (sf::Mouse::Button)button;
+            event.mouseButton.x = x;
+            event.mouseButton.y = y;
+            break;
+        }
+        case sf::Event::MouseMoved:
+        {
+            int32_t x, y;
+            if(!readValue(input, x) || !readValue(input, y)) return false;
+            event.mouseMove.x = x;
+            event.mouseMove.y = y;
+            break;
+        }
+        default: break;
+    }
+
+    return true;
+
+}
+
+}
+
+CVInputQueue::CVInputQueue():
+    bRecording(false),
+    bReplaying(false),
+    epoch(chrono::high_resolution_clock::now()),
+    recordStart(epoch),
+    replayIndex(0)
+{
+
+}
+
+void CVInputQueue::push(const sf::Event& event)
+{
+
+    if((event.type == sf::Event::MouseMoved) &&
+       !pending.empty() && (pending.back().event.type == sf::Event::MouseMoved))
+    {
+        // Coalesce pointer motion that has not been dispatched yet
+
+        pending.back().time = now(epoch);
+        pending.back().event = event;
+        return;
+    }
+
+    pending.emplace_back();
+    pending.back().time = now(epoch);
+    pending.back().event = event;
+
+}
+
+bool CVInputQueue::pop(sf::Event& event)
+{
+
+    if(pending.empty()) return false;
+
+    CVInputEvent& next = pending.front();
+    event = next.event;
+
+    if(bRecording && !frames.empty() && recordable(event.type))
+    {
+        frames.back().events.emplace_back(next);
+
+        // Stamp relative to the recording rather than the queue
+
+        const uint64_t offset = chrono::duration_cast<chrono::microseconds>(recordStart - epoch).count();
+        frames.back().events.back().time = next.time > offset ? next.time - offset : 0;
+    }
+
+    pending.pop_front();
+    return true;
+
+}
+
+void CVInputQueue::clear()
+{
+    pending.clear();
+}
+
+void CVInputQueue::startRecording()
+{
+    stopReplay();
+
+    frames.clear();
+    recordStart = chrono::high_resolution_clock::now();
+    bRecording = true;
+}
+
+void CVInputQueue::stopRecording()
+{
+    bRecording = false;
+}
+
+void CVInputQueue::beginFrame(const float& frameTime,
+                              const sf::Vector2i& mousePosition,
+                              const sf::Vector2i& globalMousePosition,
+                              const bool& focus)
+{
+
+    if(!bRecording) return;
+
+    frames.emplace_back();
+    CVInputFrame& frame = frames.back();
+
+    frame.time = now(recordStart);
+    frame.frameTime = frameTime;
+    frame.mousePosition = mousePosition;
+    frame.globalMousePosition = globalMousePosition;
+    frame.focus = focus;
+
+}
+
+bool CVInputQueue::save(const string& filename) const
+{
+
+    ofstream output(filename, ios::out | ios::binary | ios::trunc);
+
+    if(!output.is_open())
+    {
+        cout << "Warning (CVision): unable to open input recording \"" << filename << "\" for writing\n";
+        return false;
+    }
+
+    output.write(CV_INPUT_MAGIC, sizeof(CV_INPUT_MAGIC));
+    writeValue<uint32_t>(output, CV_INPUT_VERSION);
+    writeValue<uint32_t>(output, frames.size());
+
+    for(auto& frame : frames)
+    {
+        writeValue<uint64_t>(output, frame.time);
+        writeValue<float>(output, frame.frameTime);
+        writeValue<int32_t>(output, frame.mousePosition.x);
+        writeValue<int32_t>(output, frame.mousePosition.y);
+        writeValue<int32_t>(output, frame.globalMousePosition.x);
+        writeValue<int32_t>(output, frame.globalMousePosition.y);
+        writeValue<uint8_t>(output, frame.focus);
+        writeValue<uint32_t>(output, frame.events.size());
+
+        for(auto& input : frame.events)
+        {
+            const uint64_t offset = input.time > frame.time ? input.time - frame.time : 0;
+            writeValue<uint32_t>(output, offset > numeric_limits<uint32_t>::max() ?
+                                            numeric_limits<uint32_t>::max() : (uint32_t)offset);
+            writeEvent(output, input.event);
+        }
+    }
+
+    return output.good();
+
+}
+
+bool CVInputQueue::load(const string& filename)
+{
+
+    ifstream input(filename, ios::in | ios::binary | ios::ate);
+
+    if(!input.is_open())
+    {
+        cout << "Warning (CVision): unable to open input recording \"" << filename << "\"\n";
+        return false;
+    }
+
+    const uint64_t fileSize = input.tellg();
+    input.seekg(0);
+
+    // Counts are checked against the bytes left to read before anything
+    // is allocated for them, so a corrupt count cannot request more memory
+    // than the file could hold
+
+    const uint64_t frameHeaderSize = sizeof(uint64_t) + sizeof(float) + 4*sizeof(int32_t) +
+                                     sizeof(uint8_t) + sizeof(uint32_t),
+                   minEventSize = sizeof(uint32_t) + 1;
+
+    auto remaining = [&]() -> uint64_t
+    {
+        const streamoff position = input.tellg();
+        return (position < 0) || (uint64_t(position) > fileSize) ? 0 : fileSize - position;
+    };
+
+    char magic[sizeof(CV_INPUT_MAGIC)];
+    uint32_t version, frameCount;
+
+    if(!input.read(magic, sizeof(magic)) ||
+       memcmp(magic, CV_INPUT_MAGIC, sizeof(magic)) ||
+       !readValue(input, version) || (version != CV_INPUT_VERSION) ||
+       !readValue(input, frameCount))
+    {
+        cout << "Warning (CVision): \"" << filename << "\" is not a supported input recording\n";
+        return false;
+    }
+
+    if(frameCount > remaining()/frameHeaderSize)
+    {
+        cout << "Warning (CVision): input recording \"" << filename << "\" is truncated or corrupt\n";
+        return false;
+    }
+
+    vector<CVInputFrame> loaded;
+    loaded.reserve(frameCount);
+
+    for(uint32_t i = 0; i < frameCount; ++i)
+    {
+        loaded.emplace_back();
+        CVInputFrame& frame = loaded.back();
+
+        uint8_t focus;
+        uint32_t eventCount;
+
+        if(!readValue(input, frame.time) ||
+           !readValue(input, frame.frameTime) ||
+           !readValue(input, frame.mousePosition.x) ||
+           !readValue(input, frame.mousePosition.y) ||
+           !readValue(input, frame.globalMousePosition.x) ||
+           !readValue(input, frame.globalMousePosition.y) ||
+           !readValue(input, focus) ||
+           !readValue(input, eventCount))
+        {
+            cout << "Warning (CVision): input recording \"" << filename << "\" is truncated\n";
+            return false;
+        }
+
+        frame.focus = focus;
+
+        if(eventCount > remaining()/minEventSize)
+        {
+            cout << "Warning (CVision): input recording \"" << filename << "\" is truncated or corrupt\n";
+            return false;
+        }
+
+        frame.events.reserve(eventCount);
+
+        for(uint32_t j = 0; j < eventCount; ++j)
+        {
+            frame.events.emplace_back();
+            CVInputEvent& event = frame.events.back();
+
+            uint32_t offset;
+            if(!readValue(input, offset) || !readEvent(input, event.event))
+            {
+                cout << "Warning (CVision): input recording \"" << filename << "\" is truncated or corrupt\n";
+                return false;
+            }
+            event.time = frame.time + offset;
+        }
+    }
+
+    stopRecording();
+    stopReplay();
+
+    frames = move(loaded);
+
+    return true;
+
+}
+
+bool CVInputQueue::startReplay()
+{
+
+    if(frames.empty()) return false;
+
+    stopRecording();
+    pending.clear();
+
+    replayIndex = 0;
+    bReplaying = true;
+
+    return true;
+
+}
+
+void CVInputQueue::stopReplay()
+{
+    if(bReplaying) pending.clear();
+    bReplaying = false;
+    replayIndex = 0;
+}
+
+const CVInputFrame* CVInputQueue::nextFrame()
+{
+
+    if(!bReplaying) return nullptr;
+
+    if(replayIndex >= frames.size())
+    {
+        stopReplay();
+        return nullptr;
+    }
+
+    const CVInputFrame& frame = frames[replayIndex++];
+
+    pending.clear();
+    pending.insert(pending.end(), frame.events.begin(), frame.events.end());
+
+    return &frame;
+
+}
+
+}
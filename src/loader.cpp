@@ -0,0 +1,260 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/loader.hpp"
+#include "cvision/app.hpp"
+#include "cvision/widgets.hpp"
+#include "cvision/threadpool.hpp"
+
+#include <iostream>
+
+using namespace std;
+
+namespace cvis
+{
+
+CVAssetLoader::CVAssetLoader(CVApp* app):
+    mainApp(app),
+    decodeThread(nullptr),
+    total(0),
+    decoded(0),
+    loaded(0),
+    failed(0)
+{
+
+}
+
+CVAssetLoader::~CVAssetLoader()
+{
+    join();
+}
+
+void CVAssetLoader::queue(const AssetType& type,
+                          const string& fileName,
+                          const string& tag)
+{
+    pending.emplace_back(new Asset{ type, tag, fileName, nullptr, 0, false, nullptr, nullptr });
+    ++total;
+}
+
+void CVAssetLoader::queue(const AssetType& type,
+                          const void* binaries,
+                          const size_t& size,
+                          const string& tag)
+{
+    pending.emplace_back(new Asset{ type, tag, string(), binaries, size, false, nullptr, nullptr });
+    ++total;
+}
+
+void CVAssetLoader::decode(Asset& asset)
+{
+    if(asset.type == ASSET_FONT)
+    {
+        asset.font.reset(new sf::Font());
+        asset.bDecoded = asset.binaries ? asset.font->loadFromMemory(asset.binaries, asset.size) :
+                                          asset.font->loadFromFile(asset.fileName);
+    }
+    else
+    {
+        asset.image.reset(new sf::Image());
+        asset.bDecoded = asset.binaries ? asset.image->loadFromMemory(asset.binaries, asset.size) :
+                                          asset.image->loadFromFile(asset.fileName);
+    }
+}
+
+void CVAssetLoader::join()
+{
+    if(decodeThread)
+    {
+        decodeThread->join();
+        delete(decodeThread);
+        decodeThread = nullptr;
+    }
+}
+
+void CVAssetLoader::start()
+{
+    if(pending.empty()) return;
+
+    join(); // Wait for the previous batch to finish decoding
+
+    vector<Asset*> batch;
+    batch.reserve(pending.size());
+
+    for(auto& asset : pending)
+    {
+        batch.push_back(asset.get());
+        decoding.emplace_back(std::move(asset));
+    }
+    pending.clear();
+
+    CVThreadPool* pool = &mainApp->threadPool();
+
+    decodeThread = new thread([this, pool, batch]()
+    {
+        pool->parallelFor(batch.size(), [this, &batch](const size_t& i)
+        {
+            try
+            {
+                decode(*batch[i]);
+            }catch(...)
+            {
+                batch[i]->bDecoded = false;
+            }
+
+            lock_guard<mutex> lock(readyLock);
+            ready.push_back(batch[i]);
+            ++decoded;
+            readySignal.notify_all();
+        });
+    });
+}
+
+size_t CVAssetLoader::upload(const size_t& maxItems)
+{
+    vector<Asset*> batch;
+
+    {
+        lock_guard<mutex> lock(readyLock);
+        while(!ready.empty() && (!maxItems || (batch.size() < maxItems)))
+        {
+            batch.push_back(ready.front());
+            ready.pop_front();
+        }
+    }
+
+    // Uploads and mipmaps happen here, on the thread that owns the context
+
+    for(auto& asset : batch)
+    {
+        bool bLoaded = false;
+
+        if(asset->bDecoded)
+        {
+            switch(asset->type)
+            {
+                case ASSET_TEXTURE:
+                {
+                    bLoaded = mainApp->bitmaps.addTexture(*asset->image, asset->tag);
+                    break;
+                }
+                case ASSET_IMAGE:
+                {
+                    bLoaded = mainApp->bitmaps.addImage(std::move(asset->image), asset->tag);
+                    break;
+                }
+                case ASSET_FONT:
+                {
+                    bLoaded = mainApp->fonts.addFont(asset->font.release(), asset->tag);
+                    break;
+                }
+            }
+        }
+
+        if(bLoaded) ++loaded;
+        else
+        {
+            cout << "Warning (CVision): failed to load asset \"" << asset->tag << "\"\n";
+            ++failed;
+        }
+
+        asset->image.reset();
+        asset->font.reset();
+    }
+
+    if(finished())
+    {
+        join();
+        decoding.clear();
+    }
+
+    if(!batch.empty() && progressCallback) progressCallback(progress());
+
+    return batch.size();
+}
+
+size_t CVAssetLoader::load()
+{
+    size_t initLoaded = loaded;
+
+    start();
+
+    while(!finished())
+    {
+        {
+            unique_lock<mutex> lock(readyLock);
+            readySignal.wait(lock, [this](){ return !ready.empty(); });
+        }
+
+        upload();
+    }
+
+    return loaded - initLoaded;
+}
+
+bool CVAssetLoader::finished() const
+{
+    return pending.empty() && (loaded + failed >= total);
+}
+
+float CVAssetLoader::progress() const
+{
+    if(!total) return 1.0f;
+    return float(decoded + loaded + failed)/(2*total);
+}
+
+void CVAssetLoader::bindProgressBar(CVProgressBar* bar)
+{
+    if(!bar)
+    {
+        progressCallback = nullptr;
+        return;
+    }
+
+    progressCallback = [bar](const float& progress)
+    {
+        bar->setProgress(progress);
+    };
+}
+
+}
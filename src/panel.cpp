@@ -50,6 +50,8 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <typeinfo>
+
 using namespace hyperC;
 
 namespace cvis
@@ -73,70 +75,109 @@ bool CVBasicViewPanel::draw(sf::RenderTarget* target)
 
     if(!CVShape::draw(target)) return false;
 
+    const bool bBatchOwner = bBatchDraw && View->renderBatch.begin(target);
+
     CV_DRAW_CLIP_BEGIN
 
     if(!bSpriteOnly)
     {
         for(auto& item : panel)
         {
-            target->draw(item);
+            View->renderBatch.draw(target, item);
         }
     }
 
-    if(bMasked) target->draw(shapeMask);
+    if(bMasked) View->renderBatch.draw(target, shapeMask);
+
+    drawSprites(target);
 
-    for(auto& sprite : spriteList)
+    for(auto& text : displayText)
     {
-        target->draw(sprite);
+        View->renderBatch.draw(target, text);
     }
 
-    for(auto& text : displayText)
+    sf::View panelView;
+
+    if(bRelativeLayout)
     {
-        target->draw(text);
+        // Compose the member offset into the target view
+
+        panelView = target->getView();
+        sf::View memberView(panelView);
+        memberView.move(-contentOffset);
+        target->setView(memberView);
     }
 
     if(bReverseDrawOrder)
     {
         for(auto& panel : boost::adaptors::reverse(viewPanelElements))
         {
-            if(bOutOfBoundsDraw || getBounds().intersects(panel->getBounds())) panel->draw(target);
+            if(bOutOfBoundsDraw || getBounds().intersects(contentBounds(panel)))
+            {
+                CV_PROFILE_ELEMENT(View->profiler, panel, "draw");
+                drawChild(panel, target);
+            }
         }
     }
     else
     {
         for(auto& panel : viewPanelElements)
         {
-            if(bOutOfBoundsDraw || getBounds().intersects(panel->getBounds())) panel->draw(target);
+            if(bOutOfBoundsDraw || getBounds().intersects(contentBounds(panel)))
+            {
+                CV_PROFILE_ELEMENT(View->profiler, panel, "draw");
+                drawChild(panel, target);
+            }
         }
     }
 
+    if(bRelativeLayout)
+    {
+        target->setView(panelView);
+    }
+
     if(is_closable())
     {
-        closeButton->draw(target);
+        drawChild(closeButton, target);
     }
 
     if(!active)
     {
-        target->draw(inactiveMask);
+        View->renderBatch.draw(target, inactiveMask);
     }
 
     if(bHasShadow)
     {
-        if(View->viewPort && View->viewPort->isOpen())
+        if(View->viewPort && View->viewPort->isOpen() && !View->pipelined())
         {
-            View->viewPort->draw(shadow);
+            View->renderBatch.draw(View->viewPort, shadow);
         }
         else
         {
-            target->draw(shadow);
+            View->renderBatch.draw(target, shadow);
         }
     }
 
     CV_DRAW_CLIP_END
 
+    if(bBatchOwner)
+    {
+        View->renderBatch.end();
+    }
+
     return true;
 }
 
+bool CVBasicViewPanel::drawsBatched() const
+{
+    return typeid(*this) == typeid(CVBasicViewPanel);
+}
+
+bool CVBasicViewPanel::supportsRelativeLayout() const
+{
+    return typeid(*this) == typeid(CVBasicViewPanel);
+}
+
 bool CVBasicViewPanel::update(CVEvent& event, const sf::Vector2f& mousePos)  // Disperse update function
 {
 
@@ -398,9 +398,7 @@ bool CVAssemblyPanel::draw(sf::RenderTarget* target){
     for(auto& item : panel){
         target->draw(item);
     }
-    for(auto& spr : spriteList){
-        target->draw(spr);
-    }
+    drawSprites(target);
     for(auto& asmb : groups){
         asmb->draw(target);
     }
@@ -47,7 +47,7 @@
 
 #include <hyper/algorithm.hpp>
 
-#include <boost/range/adaptor/reversed.hpp>
+#include <typeinfo>
 
 using namespace hyperC;
 using namespace std;
@@ -210,24 +210,18 @@ bool CVListPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
     {
 
         float moveDist = outerPadding + bounds.top -
-                         viewPanelElements.front()->getBounds().top
+                         contentBounds(viewPanelElements.front()).top
                          - scrollBarY.getScrollOffset();
 
-        for(auto& item : viewPanelElements)
-        {
-            item->move(sf::Vector2f(0.0f, moveDist));
-        }
+        moveContent(sf::Vector2f(0.0f, moveDist));
 
     }
     else if(numPanels() > 0)
     {
 
-        float moveDist = bounds.top + outerPadding - viewPanelElements.front()->getBounds().top;
+        float moveDist = bounds.top + outerPadding - contentBounds(viewPanelElements.front()).top;
 
-        for(auto& item : viewPanelElements)
-        {
-            item->move(sf::Vector2f(0.0f, moveDist));
-        }
+        moveContent(sf::Vector2f(0.0f, moveDist));
 
     }
 
@@ -235,13 +229,11 @@ bool CVListPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
     {
         if(hasFocus())
         {
-            for(auto& item : boost::adaptors::reverse(viewPanelElements))
+            CVElement* item = elementAt(mousePos);
+            if(item && event.captureMouse())
             {
-                if(item->getBounds().contains(mousePos) && event.captureMouse())
-                {
-                    clearSelection();
-                    setSelection(item, true);
-                }
+                clearSelection();
+                setSelection(item, true);
             }
         }
         else setFocus(false);
@@ -258,6 +250,11 @@ bool CVListPanel::draw(sf::RenderTarget* target)
     return true;
 }
 
+bool CVListPanel::supportsRelativeLayout() const
+{
+    return typeid(*this) == typeid(CVListPanel);    // Grid layout places members in panel space
+}
+
 void CVListPanel::addTextEntry(const string& newText, const unsigned int& index)
 {
     CVTextBox* newItem = new CVTextBox(View, sf::Vector2f(bounds.left + innerPadding,
@@ -440,7 +437,7 @@ void CVListPanel::fitElements(const bool& fitX, const bool& fitY)
 
     if(numPanels())
     {
-        elementBounds = viewPanelElements.front()->getBounds();
+        elementBounds = contentBounds(viewPanelElements.front());
     }
     else
     {
@@ -451,7 +448,7 @@ void CVListPanel::fitElements(const bool& fitX, const bool& fitY)
     for(size_t i = 1; i < numPanels(); ++i)
     {
 
-        expandBounds(elementBounds, viewPanelElements[i]->getBounds());
+        expandBounds(elementBounds, contentBounds(viewPanelElements[i]));
 
     }
 
@@ -496,7 +493,7 @@ void CVListPanel::addPanelElement(CVElement* newElement,
     {
         if(index < numPanels())
         {
-            newElement->setPosition(viewPanelElements[index]->getPosition());
+            newElement->setPosition(viewPanelElements[index]->getPosition() + contentOffset);
             for(size_t i = index; i < numPanels(); ++i)
             {
                 viewPanelElements[index]->anim_move(sf::Vector2f(0.0f, newElement->getBounds().height + listPadding), 1100);
@@ -505,8 +502,8 @@ void CVListPanel::addPanelElement(CVElement* newElement,
         else
         {
             newElement->setPosition(bounds.left + outerPaddingActual,
-                                    viewPanelElements.back()->getBounds().top +
-                                    viewPanelElements.back()->getBounds().height + listPadding);
+                                    contentBounds(viewPanelElements.back()).top +
+                                    contentBounds(viewPanelElements.back()).height + listPadding);
         }
     }
 
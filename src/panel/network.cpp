@@ -326,7 +326,7 @@ void CVNetworkNode::setViewScale(const float& newScale)
 
 void CVNetworkNode::setSprite(const sf::Texture* newTexture)
 {
-    element->getSprite(0).setTexture(*newTexture, true);
+    element->setSpriteTexture(element->getSprite(0), newTexture);
 }
 
 void CVNetworkNode::setWeight(const float& newWeight,
@@ -342,7 +342,7 @@ void CVNetworkNode::setWeight(const float& newWeight,
 
 }
 
-void CVNetworkNode::setTag(const std::string& newTag) noexcept
+void CVNetworkNode::setTag(const std::string& newTag)
 {
 
     element->setTag(newTag);
@@ -252,8 +252,7 @@ bool CVNodePanel::update(CVEvent& event, const sf::Vector2f& mousePos)
 
         if(viewPanelElements[i]->shouldDelete())
         {
-            delete(viewPanelElements[i]);
-            viewPanelElements.erase(viewPanelElements.begin() + i);
+            CVViewPanel::removePanelElement(i); // Also drops it from the hit grid
         }
         else
         {
@@ -191,10 +191,7 @@ void CVSwitchPanel::removePanelElement(const unsigned int& index)
         viewPanelElements[i]->move(sf::Vector2f(-panelBounds.width, 0.0f));
     }
 
-    if(bExpand)
-    {
-        updateBounds();
-    }
+    invalidateBounds();
 
     if(viewIndex > (int)index) setCenter(viewIndex - 1);
     else setCenter(viewIndex);
@@ -231,23 +228,7 @@ bool CVSwitchPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
 
     if(!CVViewPanel::update(event, mousePos)) return false;
 
-    for(int i = viewPanelElements.size() - 1; (i >= 0) && !viewPanelElements.empty(); --i)
-    {
-        if(viewPanelElements[i]->shouldDelete())
-        {
-            removePanelElement(i);
-        }
-        else
-        {
-            if(bOutOfBoundsUpdate || View->contains(*viewPanelElements[i]))
-            {
-                if(!bClipBounds || panel.front().getGlobalBounds().intersects(viewPanelElements[i]->getBounds()))
-                {
-                    viewPanelElements[i]->update(event, mousePos);
-                }
-            }
-        }
-    }
+    updatePanels(event, mousePos);
 
     if(bCanPan)
     {
@@ -1790,6 +1790,12 @@ void CVPlot::addData(const hyperC::numMatrix& matrix,
     callUpdate();
 }
 
+bool CVPlot::needsUpdate() const
+{
+    return CVTextBox::needsUpdate() || !dataAddRequests.empty() ||
+            (framesLastChange < 5); // Subclasses rebuild geometry over the frames following callUpdate()
+}
+
 bool CVPlot::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
@@ -0,0 +1,319 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/profiler.hpp"
+#include "cvision/element.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <typeinfo>
+#include <typeindex>
+#include <unordered_map>
+#include <mutex>
+
+#if defined __GNUC__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+using namespace std;
+
+namespace cvis
+{
+
+namespace
+{
+
+const string& typeName(const type_info& info)   // Readable class name, cached per type
+{
+
+    static unordered_map<type_index, string> names;
+    static mutex namesLock;
+
+    lock_guard<mutex> lock(namesLock);
+
+    auto it = names.find(type_index(info));
+    if(it != names.end())
+    {
+        return it->second;
+    }
+
+    string name = info.name();
+
+    #if defined __GNUC__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.name(), nullptr, nullptr, &status);
+    if(demangled)
+    {
+        if(status == 0) name = demangled;
+        free(demangled);
+    }
+    #endif
+
+    return names.emplace(type_index(info), name).first->second;
+
+}
+
+void writeJSONString(ostream& output, const string& str)
+{
+    output << '"';
+    for(auto& c : str)
+    {
+        switch(c)
+        {
+            case '"':   output << "\\\""; break;
+            case '\\':  output << "\\\\"; break;
+            case '\n':  output << "\\n"; break;
+            case '\r':  output << "\\r"; break;
+            case '\t':  output << "\\t"; break;
+            default:
+            {
+                if((unsigned char)c < 0x20) output << ' ';
+                else output << c;
+            }
+        }
+    }
+    output << '"';
+}
+
+}
+
+CVProfiler::CVProfiler(const size_t& frameCapacity):
+    bEnabled(false),
+    bFrameOpen(false),
+    bRequested(false),
+    bClearRequested(false),
+    capacity(frameCapacity ? frameCapacity : 1),
+    frameCount(0),
+    epoch(chrono::high_resolution_clock::now())
+{
+
+}
+
+void CVProfiler::setFrameCapacity(const size_t& frameCapacity)
+{
+    capacity = frameCapacity ? frameCapacity : 1;
+}
+
+void CVProfiler::beginFrame()
+{
+
+    if(bFrameOpen)
+    {
+        endFrame();
+    }
+
+    bEnabled = bRequested;
+
+    lock_guard<mutex> lock(framesLock);
+
+    if(bClearRequested.exchange(false))
+    {
+        frames.clear();
+    }
+
+    const size_t kept = bEnabled ? capacity - 1 : capacity.load();   // Leave room for the new frame
+    while(frames.size() > kept)
+    {
+        frames.pop_front();
+    }
+
+    if(!bEnabled) return;
+
+    owner = this_thread::get_id();
+
+    frames.emplace_back();
+    frames.back().index = frameCount++;
+    frames.back().start = now();
+    frames.back().duration = 0.0;
+
+    openSamples.clear();
+    bFrameOpen = true;
+
+}
+
+void CVProfiler::endFrame()
+{
+
+    if(!bFrameOpen) return;
+
+    lock_guard<mutex> lock(framesLock);
+
+    const double t = now();
+    CVProfileFrame& frame = frames.back();
+
+    for(auto& index : openSamples)  // Close any samples left open
+    {
+        frame.samples[index].duration = t - frame.samples[index].start;
+    }
+    openSamples.clear();
+
+    frame.duration = t - frame.start;
+    bFrameOpen = false;
+
+}
+
+size_t CVProfiler::beginSample(const string& name, const char* category)
+{
+
+    if(!bFrameOpen || (this_thread::get_id() != owner)) return SIZE_MAX;
+
+    vector<CVProfileSample>& samples = frames.back().samples;
+
+    samples.emplace_back();
+    CVProfileSample& sample = samples.back();
+
+    auto it = names.find(name);
+    if(it == names.end()) it = names.insert(name).first;
+
+    sample.name = &*it;
+    sample.category = category;
+    sample.depth = openSamples.size();
+    sample.parent = openSamples.empty() ? SIZE_MAX : openSamples.back();
+    sample.duration = 0.0;
+    sample.start = now();
+
+    openSamples.push_back(samples.size() - 1);
+
+    return samples.size() - 1;
+
+}
+
+size_t CVProfiler::beginSample(const CVElement& element, const char* category)
+{
+    if(!bFrameOpen || (this_thread::get_id() != owner)) return SIZE_MAX;
+
+    if(!element.tag().empty())
+    {
+        return beginSample(element.tag(), category);
+    }
+    return beginSample(typeName(typeid(element)), category);
+}
+
+void CVProfiler::endSample(const size_t& index)
+{
+
+    if(!bFrameOpen || (this_thread::get_id() != owner) ||
+       (index >= frames.back().samples.size())) return;
+
+    vector<CVProfileSample>& samples = frames.back().samples;
+    samples[index].duration = now() - samples[index].start;
+
+    while(!openSamples.empty())
+    {
+        const size_t top = openSamples.back();
+        openSamples.pop_back();
+        if(top == index) break;
+    }
+
+}
+
+deque<CVProfileFrame> CVProfiler::snapshot() const
+{
+
+    // The open frame's samples are still being written without the lock
+
+    lock_guard<mutex> lock(framesLock);
+
+    if(bClearRequested) return deque<CVProfileFrame>();
+
+    deque<CVProfileFrame> output(frames.begin(), frames.end() - (bFrameOpen ? 1 : 0));
+    return output;
+
+}
+
+void CVProfiler::clear()
+{
+    bClearRequested = true;
+}
+
+void CVProfiler::writeChromeTrace(ostream& output, const string& threadName) const
+{
+
+    output << "{\"traceEvents\":[";
+
+    output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":";
+    writeJSONString(output, threadName.empty() ? string("CVView") : threadName);
+    output << "}}";
+
+    for(auto& frame : snapshot())
+    {
+        output << ",\n{\"name\":\"Frame " << frame.index << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+               << ",\"ts\":" << frame.start << ",\"dur\":" << frame.duration << '}';
+
+        for(auto& sample : frame.samples)
+        {
+            output << ",\n{\"name\":";
+            writeJSONString(output, *sample.name);
+            output << ",\"cat\":\"" << (sample.category ? sample.category : "") << "\""
+                   << ",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+                   << ",\"ts\":" << sample.start << ",\"dur\":" << sample.duration
+                   << ",\"args\":{\"depth\":" << sample.depth << "}}";
+        }
+    }
+
+    output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+}
+
+bool CVProfiler::exportChromeTrace(const string& filename, const string& threadName) const
+{
+
+    ofstream output(filename, ios::out | ios::trunc);
+
+    if(!output.is_open())
+    {
+        cout << "Warning (CVision): unable to open profiler trace file \"" << filename << "\"\n";
+        return false;
+    }
+
+    output.precision(3);
+    output << fixed;
+
+    writeChromeTrace(output, threadName);
+
+    return output.good();
+
+}
+
+}
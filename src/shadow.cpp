@@ -0,0 +1,172 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/shadow.hpp"
+#include "cvision/imageops.hpp"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace cvis
+{
+
+CVShadowCache::CVShadowCache():
+    hits(0),
+    misses(0)
+{
+
+}
+
+// Signed distance from a pixel centre to the outline of a rectangle
+// with per-corner rounding, negative inside
+
+inline static float roundedRectDistance(const float& x, const float& y,
+                                        const float& width, const float& height,
+                                        const float& rounding, const uint8_t& corners)
+{
+    const float cx = width/2, cy = height/2;
+    const bool right = x > cx,
+               bottom = y > cy;
+
+    uint8_t corner = bottom ? (right ? CV_CORNER_BOTTOM_RIGHT : CV_CORNER_BOTTOM_LEFT) :
+                              (right ? CV_CORNER_TOP_RIGHT : CV_CORNER_TOP_LEFT);
+    const float r = (corners & corner) ? rounding : 0.0f;
+
+    const float qx = abs(x - cx) - (cx - r),
+                qy = abs(y - cy) - (cy - r);
+
+    const float ox = max(qx, 0.0f),
+                oy = max(qy, 0.0f);
+
+    return sqrt(ox*ox + oy*oy) + min(max(qx, qy), 0.0f) - r;
+}
+
+shared_ptr<const sf::Texture> CVShadowCache::get(const sf::Vector2f& size,
+                                                  const float& rounding,
+                                                  const uint8_t& corners,
+                                                  const int& radius,
+                                                  CVThreadPool* pool)
+{
+    const int width = round(size.x),
+              height = round(size.y);
+
+    if((width < 1) || (height < 1)) return nullptr;
+
+    const float r = min(max(rounding, 0.0f), min(width, height)/2.0f);
+    const uint8_t cornerMask = (r > 0.0f) ? (corners & CV_CORNER_ALL) : 0;
+    const Key key(width, height, int(round(r*4)), max(radius, 0), cornerMask);
+
+    lock_guard<mutex> lock(cacheLock);
+
+    auto it = shadows.find(key);
+    if(it != shadows.end())
+    {
+        shared_ptr<const sf::Texture> texture = it->second.lock();
+        if(texture)
+        {
+            ++hits;
+            return texture;
+        }
+    }
+
+    if(!(++misses % 64)) prune();
+
+    // Rasterize the outline with one pixel of anti-aliasing, then blur.  Colour
+    // is white throughout so the sprite colour tints it
+
+    const int m = margin(radius);
+    const unsigned int canvasWidth = width + 2*m,
+                       canvasHeight = height + 2*m;
+
+    vector<uint8_t> pixels(size_t(canvasWidth)*canvasHeight*4, 255);
+    for(size_t i = 3; i < pixels.size(); i += 4) pixels[i] = 0;
+
+    for(int y = 0; y < height; ++y)
+    {
+        uint8_t* row = &pixels[(size_t(y + m)*canvasWidth + m)*4];
+        for(int x = 0; x < width; ++x)
+        {
+            const float coverage = 0.5f - roundedRectDistance(x + 0.5f, y + 0.5f, width, height,
+                                                              r, cornerMask);
+            row[x*4 + 3] = coverage >= 1.0f ? 255 : coverage <= 0.0f ? 0 : uint8_t(coverage*255 + 0.5f);
+        }
+    }
+
+    gaussianBlur(CVImageSpan(pixels, canvasWidth, canvasHeight), radius, pool);
+
+    shared_ptr<sf::Texture> texture = make_shared<sf::Texture>();
+    if(!texture->create(canvasWidth, canvasHeight)) return nullptr;
+
+    texture->update(pixels.data());
+    texture->setSmooth(true);
+
+    shadows[key] = texture;
+    return texture;
+}
+
+void CVShadowCache::prune()
+{
+    for(auto it = shadows.begin(); it != shadows.end();)
+    {
+        if(it->second.expired()) it = shadows.erase(it);
+        else ++it;
+    }
+}
+
+size_t CVShadowCache::size()
+{
+    lock_guard<mutex> lock(cacheLock);
+    prune();
+    return shadows.size();
+}
+
+void CVShadowCache::clear()
+{
+    lock_guard<mutex> lock(cacheLock);
+    shadows.clear();
+}
+
+}
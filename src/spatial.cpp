@@ -0,0 +1,272 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/spatial.hpp"
+#include "cvision/element.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+namespace cvis
+{
+
+namespace
+{
+
+const int maxCellSpan = 1024;   // Elements overlapping more cells are kept in the oversized list
+
+inline void eraseElement(vector<CVElement*>& list, const CVElement* element)
+{
+    auto it = find(list.begin(), list.end(), element);
+    if(it != list.end())
+    {
+        *it = list.back();
+        list.pop_back();
+    }
+}
+
+}
+
+CVSpatialGrid::CVSpatialGrid(const float& cellSize):
+    cellSize(cellSize > 0.0f ? cellSize : 64.0f)
+{
+
+}
+
+void CVSpatialGrid::setCellSize(const float& newSize)
+{
+
+    if((newSize <= 0.0f) || (newSize == cellSize)) return;
+
+    cellSize = newSize;
+
+    cells.clear();
+    oversized.clear();
+
+    for(auto& pair : entries)
+    {
+        bin(const_cast<CVElement*>(pair.first), pair.second);
+    }
+
+}
+
+void CVSpatialGrid::insert(CVElement* element)
+{
+
+    lock_guard<mutex> lock(pendingLock);
+
+    if(contains(element)) return;
+
+    Entry& entry = entries[element];
+    entry.bPending = false;
+    bin(element, entry);
+
+}
+
+void CVSpatialGrid::remove(const CVElement* element)
+{
+
+    lock_guard<mutex> lock(pendingLock);
+
+    auto it = entries.find(element);
+    if(it == entries.end()) return;
+
+    unbin(element, it->second);
+
+    if(it->second.bPending)
+    {
+        eraseElement(pending, element);
+    }
+
+    entries.erase(it);
+
+}
+
+void CVSpatialGrid::update(CVElement* element)
+{
+
+    auto it = entries.find(element);
+    if(it == entries.end()) return;
+
+    const sf::FloatRect& bounds = element->getBounds();
+    if(bounds == it->second.bounds) return;
+
+    unbin(element, it->second);
+    bin(element, it->second);
+
+}
+
+void CVSpatialGrid::clear()
+{
+
+    lock_guard<mutex> lock(pendingLock);
+
+    entries.clear();
+    cells.clear();
+    oversized.clear();
+    pending.clear();
+
+}
+
+void CVSpatialGrid::markMoved(CVElement* element)
+{
+
+    lock_guard<mutex> lock(pendingLock);
+
+    auto it = entries.find(element);
+    if((it == entries.end()) || it->second.bPending) return;
+
+    it->second.bPending = true;
+    pending.push_back(element);
+
+}
+
+void CVSpatialGrid::flush()
+{
+
+    vector<CVElement*> moved;
+
+    {
+        lock_guard<mutex> lock(pendingLock);
+        moved.swap(pending);
+        for(auto& element : moved)
+        {
+            entries[element].bPending = false;
+        }
+    }
+
+    for(auto& element : moved)
+    {
+        update(element);
+    }
+
+}
+
+void CVSpatialGrid::query(const sf::Vector2f& point, vector<CVElement*>& output) const
+{
+
+    if(isnan(point.x) || isnan(point.y)) return;
+
+    auto it = cells.find(cellKey(floor(point.x/cellSize), floor(point.y/cellSize)));
+    if(it != cells.end())
+    {
+        for(auto& element : it->second)
+        {
+            if(element->getBounds().contains(point))
+            {
+                output.push_back(element);
+            }
+        }
+    }
+
+    for(auto& element : oversized)
+    {
+        if(element->getBounds().contains(point))
+        {
+            output.push_back(element);
+        }
+    }
+
+}
+
+void CVSpatialGrid::bin(CVElement* element, Entry& entry)
+{
+
+    entry.bounds = element->getBounds();
+
+    const float left = floor(entry.bounds.left/cellSize),
+                top = floor(entry.bounds.top/cellSize),
+                right = floor((entry.bounds.left + entry.bounds.width)/cellSize),
+                bottom = floor((entry.bounds.top + entry.bounds.height)/cellSize);
+
+    // NaN bounds fail every comparison and are kept with the oversized elements
+
+    entry.bOversized = !((right - left + 1.0f)*(bottom - top + 1.0f) <= maxCellSpan);
+
+    if(entry.bOversized)
+    {
+        oversized.push_back(element);
+        return;
+    }
+
+    entry.cells = sf::IntRect(left, top, right - left, bottom - top);
+
+    for(int y = entry.cells.top; y <= entry.cells.top + entry.cells.height; ++y)
+    {
+        for(int x = entry.cells.left; x <= entry.cells.left + entry.cells.width; ++x)
+        {
+            cells[cellKey(x, y)].push_back(element);
+        }
+    }
+
+}
+
+void CVSpatialGrid::unbin(const CVElement* element, Entry& entry)
+{
+
+    if(entry.bOversized)
+    {
+        eraseElement(oversized, element);
+        return;
+    }
+
+    for(int y = entry.cells.top; y <= entry.cells.top + entry.cells.height; ++y)
+    {
+        for(int x = entry.cells.left; x <= entry.cells.left + entry.cells.width; ++x)
+        {
+            auto it = cells.find(cellKey(x, y));
+            if(it == cells.end()) continue;
+
+            eraseElement(it->second, element);
+            if(it->second.empty())
+            {
+                cells.erase(it);
+            }
+        }
+    }
+
+}
+
+}
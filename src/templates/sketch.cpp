@@ -45,7 +45,9 @@
 #include "cvision/panel/button.hpp"
 #include "cvision/view.hpp"
 #include "cvision/app.hpp"
+#include "cvision/imageops.hpp"
 
+#include <climits>
 
 #include "hyper/algorithm.hpp"
 
@@ -53,6 +55,27 @@ using namespace hyperC;
 
 namespace cvis{
 
+static const int strokeBandHeight = 32; // Rows per dirty rect reported by a stroke
+static const size_t maxDirtyRects = 64; // Beyond this a layer uploads their bounds instead
+
+static sf::IntRect mergeRects(const sf::IntRect& A, const sf::IntRect& B){
+    if((A.width <= 0) || (A.height <= 0)) return B;
+    if((B.width <= 0) || (B.height <= 0)) return A;
+
+    const int left = std::min(A.left, B.left),
+              top = std::min(A.top, B.top);
+
+    return sf::IntRect(left, top,
+                       std::max(A.left + A.width, B.left + B.width) - left,
+                       std::max(A.top + A.height, B.top + B.height) - top);
+}
+
+static sf::IntRect clipToImage(const sf::IntRect& region, const sf::Vector2u& size){
+    sf::IntRect output;
+    if(!region.intersects(sf::IntRect(0, 0, size.x, size.y), output)) return sf::IntRect();
+    return output;
+}
+
 CVBrush::CVBrush(const sf::Color& color,
             const float& radius,
             const float& rounding,
@@ -67,7 +90,9 @@ CVBrush::CVBrush(const sf::Color& color,
                 dimensions(1.0f,1.0f),
                 drawScale(1.0f, 1.0f),
                 icon(nullptr),
+                fillTolerance(0),
                 bVisible(false),
+                bDiagonalFill(false),
                 effect(brushEffect),
                 type(brushType){ }
 
@@ -79,69 +104,196 @@ void CVBrush::clearIcon(){
     icon = nullptr;
 }
 
-void CVBrush::drawToImage(sf::Image& image, const sf::Vector2i& coords){
-    switch(type){
-        case CVBrush::square:{
-            for(int x = coords.x - dimensions.x; x < coords.x + dimensions.x; ++x){
-                if(x >= image.getSize().x) continue;
-                for(int y = coords.y - dimensions.y; y < coords.y + dimensions.y; ++y){
-                    if(y >= image.getSize().y) continue;
-                    if(sf::Mouse::isButtonPressed(sf::Mouse::Left)) image.setPixel(x, y, primaryColor);
-                    else if(sf::Mouse::isButtonPressed(sf::Mouse::Right)) image.setPixel(x, y, secondaryColor);
-                }
-            }
-            break;
-        }
-        case CVBrush::rounded:{
-            for(int x = coords.x - dimensions.x; x < coords.x + dimensions.x; ++x){
-                if(x >= image.getSize().x) continue;
-                for(int y = coords.y - dimensions.y; y < coords.y + dimensions.y; ++y){
-                    if(y >= image.getSize().y) continue;
+bool CVBrush::mouseColor(sf::Color& output) const{
+    if(sf::Mouse::isButtonPressed(sf::Mouse::Left)) output = primaryColor;
+    else if(sf::Mouse::isButtonPressed(sf::Mouse::Right)) output = secondaryColor;
+    else return false;
 
-                    if(getDistance(sf::Vector2f(coords), sf::Vector2f(x,y)) > dimensions.x){
-                        continue;
-                    }
+    return true;
+}
 
-                    if(sf::Mouse::isButtonPressed(sf::Mouse::Left)) image.setPixel(x, y, primaryColor);
-                    else if(sf::Mouse::isButtonPressed(sf::Mouse::Right)) image.setPixel(x, y, secondaryColor);
-                }
-            }
+// Pixels one dab may touch, clipped to the stroke's region
+
+static sf::IntRect dabBounds(const sf::IntRect& region,
+                             const sf::Vector2f& center,
+                             const sf::Vector2f& extent,
+                             const float& feather){
+    const int left = std::max(region.left, int(floor(center.x - extent.x - feather))),
+              top = std::max(region.top, int(floor(center.y - extent.y - feather))),
+              right = std::min(region.left + region.width, int(ceil(center.x + extent.x + feather))),
+              bottom = std::min(region.top + region.height, int(ceil(center.y + extent.y + feather)));
+
+    return sf::IntRect(left, top, right - left, bottom - top);
+}
+
+// Merge one dab's coverage into the stroke's buffer.  Each row y of region
+// holds the image columns [spans[y].x, spans[y].y) from offsets[y] on
+
+static void stampDab(std::vector<uint8_t>& coverage,
+                     const std::vector<sf::Vector2i>& spans,
+                     const std::vector<size_t>& offsets,
+                     const sf::IntRect& region,
+                     const sf::Vector2f& center,
+                     const sf::Vector2f& extent,
+                     const float& feather,
+                     const bool& round){
+    const sf::IntRect bounds = dabBounds(region, center, extent, feather);
+
+    for(int y = bounds.top; y < bounds.top + bounds.height; ++y){
+        const sf::Vector2i& span = spans[y - region.top];
+        uint8_t* row = coverage.data() + offsets[y - region.top] - span.x;
+        const float dy = y + 0.5f - center.y;
+
+        for(int x = bounds.left; x < bounds.left + bounds.width; ++x){
+            const float dx = x + 0.5f - center.x;
+
+            // Signed distance inside the edge, spread over the feather width
+
+            const float value = round ? (extent.x - sqrt(dx*dx + dy*dy))/feather + 0.5f :
+                                        std::min(extent.x - fabs(dx), extent.y - fabs(dy))/feather + 0.5f;
+            if(value <= 0.0f) continue;
+
+            const uint8_t level = value >= 1.0f ? 255 : uint8_t(value*255 + 0.5f);
+            if(level > row[x]) row[x] = level;
+        }
+    }
+}
+
+sf::IntRect CVBrush::drawStroke(sf::Image& image,
+                                const sf::Vector2f& from,
+                                const sf::Vector2f& to,
+                                const sf::Color& color,
+                                const bool& continued,
+                                std::vector<sf::IntRect>* bands){
+    switch(type){
+        case CVBrush::square:
+        case CVBrush::rounded:{
             break;
         }
         case CVBrush::point:{
-            switch(effect){
-                case CVBrush::CVBrushEffect::connective:{
-                    for(int x = 0; x < image.getSize().x; ++x){
-                        for(int y = 0; y < image.getSize().y; ++y){
-                            if(sf::Mouse::isButtonPressed(sf::Mouse::Left)) image.setPixel(x, y, primaryColor);
-                            else if(sf::Mouse::isButtonPressed(sf::Mouse::Right)) image.setPixel(x, y, secondaryColor);
-                        }
-                    }
-                    break;
-                }
-                default:{
-                    break;
-                }
+            if((effect == CVBrushEffect::connective) && !continued){
+                const sf::IntRect filled = floodFill(imageSpan(image), sf::Vector2i(floor(to.x), floor(to.y)), color,
+                                                     fillTolerance, bDiagonalFill);
+                if(bands && (filled.width > 0)) bands->push_back(filled);
+                return filled;
             }
-            break;
+            return sf::IntRect();
         }
         default:{
-            break;
+            return sf::IntRect();
+        }
+    }
+
+    const bool round = (type == CVBrush::rounded);
+    const sf::Vector2f extent(dimensions.x, round ? dimensions.x : dimensions.y);
+    const float feather = std::max(1.0f, softening);
+
+    if((extent.x <= 0.0f) || (extent.y <= 0.0f)) return sf::IntRect();
+
+    const int left = floor(std::min(from.x, to.x) - extent.x - feather),
+              top = floor(std::min(from.y, to.y) - extent.y - feather);
+
+    const sf::IntRect region = clipToImage(sf::IntRect(left, top,
+                                                       int(ceil(std::max(from.x, to.x) + extent.x + feather)) - left,
+                                                       int(ceil(std::max(from.y, to.y) + extent.y + feather)) - top),
+                                           image.getSize());
+    if((region.width <= 0) || (region.height <= 0)) return sf::IntRect();
+
+    // Space dabs a quarter of the brush apart, so the union of their
+    // edges stays within a small fraction of a pixel of a straight edge
+
+    const sf::Vector2f delta = to - from;
+    const float spacing = std::max(0.5f, 0.25f*std::min(extent.x, extent.y));
+    const unsigned int numSteps = ceil(sqrt(delta.x*delta.x + delta.y*delta.y)/spacing);
+    const unsigned int firstStep = continued ? 1 : 0;
+
+    auto dabCenter = [&](const unsigned int& i){
+        return numSteps ? from + delta*(float(i)/numSteps) : from;
+    };
+
+    // Only the columns each row's dabs reach are zeroed, blended and
+    // uploaded, so a long diagonal costs its length rather than its box
+
+    strokeSpans.assign(region.height, sf::Vector2i(INT_MAX, INT_MIN));
+
+    for(unsigned int i = firstStep; i <= numSteps; ++i){
+        const sf::IntRect bounds = dabBounds(region, dabCenter(i), extent, feather);
+
+        for(int y = bounds.top - region.top; y < bounds.top - region.top + bounds.height; ++y){
+            strokeSpans[y].x = std::min(strokeSpans[y].x, bounds.left);
+            strokeSpans[y].y = std::max(strokeSpans[y].y, bounds.left + bounds.width);
+        }
+    }
+
+    strokeOffsets.resize(region.height);
+
+    size_t coverageSize = 0;
+    for(int y = 0; y < region.height; ++y){
+        if(strokeSpans[y].x >= strokeSpans[y].y) strokeSpans[y] = sf::Vector2i(0, 0);
+        strokeOffsets[y] = coverageSize;
+        coverageSize += strokeSpans[y].y - strokeSpans[y].x;
+    }
+
+    if(!coverageSize) return sf::IntRect();
+
+    strokeCoverage.assign(coverageSize, 0);
+
+    for(unsigned int i = firstStep; i <= numSteps; ++i){
+        stampDab(strokeCoverage, strokeSpans, strokeOffsets, region,
+                 dabCenter(i), extent, feather, round);
+    }
+
+    const CVImageSpan canvas = imageSpan(image);
+    sf::IntRect touched, band;
+
+    for(int y = 0; y < region.height; ++y){
+        const sf::Vector2i& span = strokeSpans[y];
+
+        if(span.y > span.x){
+            const sf::IntRect row(span.x, region.top + y, span.y - span.x, 1);
+
+            fillCoverage(canvas.clip(row), &strokeCoverage[strokeOffsets[y]], row.width, color);
+            band = mergeRects(band, row);
+        }
+
+        if(((y + 1) % strokeBandHeight == 0) || (y + 1 == region.height)){
+            if(bands && (band.width > 0)) bands->push_back(band);
+            touched = mergeRects(touched, band);
+            band = sf::IntRect();
         }
     }
+
+    return touched;
 }
 
-void CVBrush::drawToImage(sf::Image& image, const std::vector<sf::Vector2i>& coords){
-    for(auto& coord : coords){
-        drawToImage(image, coord);
+sf::IntRect CVBrush::drawToImage(sf::Image& image, const sf::Vector2i& coords){
+    sf::Color color;
+    if(!mouseColor(color)) return sf::IntRect();
+
+    return drawStroke(image, sf::Vector2f(coords), sf::Vector2f(coords), color);
+}
+
+sf::IntRect CVBrush::drawToImage(sf::Image& image, const std::vector<sf::Vector2i>& coords){
+    sf::Color color;
+    if(coords.empty() || !mouseColor(color)) return sf::IntRect();
+
+    sf::IntRect touched = drawStroke(image, sf::Vector2f(coords.front()), sf::Vector2f(coords.front()), color);
+    for(size_t i = 1; i < coords.size(); ++i){
+        touched = mergeRects(touched, drawStroke(image, sf::Vector2f(coords[i - 1]), sf::Vector2f(coords[i]),
+                                                 color, true));
     }
+    return touched;
 }
 
-void CVBrush::drawToImage(sf::Image& image, const vMatrix<int>& coords){
+sf::IntRect CVBrush::drawToImage(sf::Image& image, const vMatrix<int>& coords){
+    std::vector<sf::Vector2i> points;
+    points.reserve(coords.size());
+
     for(auto& coord : coords){
-        drawToImage(image,
-                    sf::Vector2i(coord[0],coord[1]));
+        points.emplace_back(coord[0], coord[1]);
     }
+
+    return drawToImage(image, points);
 }
 
 const sf::Vector2f& CVBrush::getPosition() const{
@@ -195,6 +347,14 @@ void CVBrush::setType(const CVBrushType& newType){
     type = newType;
 }
 
+void CVBrush::setFillTolerance(const unsigned int& tolerance){
+    fillTolerance = tolerance;
+}
+
+void CVBrush::setDiagonalFill(const bool& status){
+    bDiagonalFill = status;
+}
+
 bool CVBrush::draw(sf::RenderTarget* target){
     if(!bVisible || (target == nullptr)) return false;
 
@@ -246,11 +406,13 @@ CVSketchPanel::CVSketchPanel(CVView* parentView, std::string panelTag, sf::Color
                          brushCoords("", *appFont(textInfo.font), textInfo.fontSize*1.2f*View->getViewScale()),
                          fg_color(sf::Color::Black),
                          bg_color(sf::Color::White),
+                         stroke_color(sf::Color::Black),
                          selected_layer(0),
                          selected_brush(0),
                          toolset(nullptr),
                          bCanDraw(true),
-                         bBrushCoords(true){
+                         bBrushCoords(true),
+                         bStroking(false){
 
     setDrawClipping(true);
 
@@ -281,6 +443,7 @@ CVSketchPanel::CVSketchPanel(CVView* parentView, std::string panelTag, sf::Color
     brushes[3].setPrimaryColor(sf::Color::White);
     brushes[3].setSecondaryColor(sf::Color::Transparent);
     brushes[3].setEffect(CVBrush::CVBrushEffect::connective);
+    brushes[3].setFillTolerance(32);
     brushes[3].setIcon(appTexture("paintbucket_cursor"));
     brushes[3].setRadius(48.0f*View->getViewScale());
 
@@ -350,10 +513,7 @@ void CVSketchPanel::draw_to_layer(const unsigned int& index,
        !layers[index].isVisible() ||
        (selected_brush >= brushes.size())) return;
 
-    drawCanvas.create(layers[selected_layer].getSize().x, layers[selected_layer].getSize().y);
-    layers[selected_layer].getTextureImage(drawCanvas);
-    brushes[selected_brush].drawToImage(drawCanvas, coords);
-    layers[index].loadFromImage(drawCanvas);
+    layers[index].markDirty(brushes[selected_brush].drawToImage(layers[index].getImage(), coords));
 }
 
 void CVSketchPanel::draw_to_layer(const unsigned int& index,
@@ -363,71 +523,59 @@ void CVSketchPanel::draw_to_layer(const unsigned int& index,
        (selected_brush >= brushes.size()) ||
        coords.empty()) return;
 
-    drawCanvas.create(layers[selected_layer].getSize().x, layers[selected_layer].getSize().y);
-    layers[selected_layer].getTextureImage(drawCanvas);
-    brushes[selected_brush].drawToImage(drawCanvas, coords);
-    layers[index].loadFromImage(drawCanvas);
+    layers[index].markDirty(brushes[selected_brush].drawToImage(layers[index].getImage(), coords));
 }
 
-void CVSketchPanel::flattenToTexture(sf::Texture& out_tex){
-    View->captureLock.lock();
-
-    View->textureBuffer.create(layers.front().getImageSize().x,
-                               layers.front().getImageSize().y);
-    View->textureBuffer.setView(sf::View(sf::FloatRect(0.0f,0.0f,
-                                                       layers.front().getImageSize().x,
-                                                       layers.front().getImageSize().y)));
-    View->textureBuffer.clear(sf::Color::Transparent);
-
-    std::vector<CVSketchLayer> tmp_layers = layers;
-    sf::Vector2f moveDist = layers.front().getPosition() * -1.0f;
-
-    for(auto& layer : tmp_layers){
-        layer.move(moveDist);
-        layer.setScale(sf::Vector2f(1.0f,1.0f));
-        View->textureBuffer.draw(layer);
-    }
+void CVSketchPanel::stroke_layer(const unsigned int& index,
+                                 const sf::Vector2f& from,
+                                 const sf::Vector2f& to,
+                                 const sf::Color& color,
+                                 const bool& continued){
+    if(index >= layers.size() ||
+       !layers[index].isVisible() ||
+       (selected_brush >= brushes.size())) return;
 
-    View->textureBuffer.display();
-    out_tex = View->textureBuffer.getTexture();
+    std::vector<sf::IntRect> bands;
+    brushes[selected_brush].drawStroke(layers[index].getImage(), from, to, color, continued, &bands);
+    layers[index].markDirty(bands);
+}
 
-    View->captureLock.unlock();
+void CVSketchPanel::flattenToTexture(sf::Texture& out_tex){
+    sf::Image tmp;
+    flattenToImage(tmp);
+    out_tex.loadFromImage(tmp);
 }
 
 void CVSketchPanel::flattenToImage(sf::Image& out_img){
-    sf::Texture tmp;
-    flattenToTexture(tmp);
-    out_img = tmp.copyToImage();
+    if(layers.empty()) return;
+
+    // Composite the layers' own pixels, so nothing is read back from the GPU
+
+    out_img.create(layers.front().getImageSize().x,
+                   layers.front().getImageSize().y,
+                   sf::Color::Transparent);
+
+    for(auto& layer : layers){
+        const sf::Vector2i offset(layer.getPosition() - layers.front().getPosition());
+        blit(imageSpan(out_img), imageSpan(layer.getImage()), offset.x, offset.y, true);
+    }
 }
 
 void CVSketchPanel::highlight_pixels(const sf::Rect<int>& boundaries, const sf::Color& color,
                                      const bool& clear){
     if(layers.empty()) return;
 
-    highlightLayer.getTextureImage(drawCanvas);
-    if(clear) setImageColor(drawCanvas, sf::Color::Transparent);
-
-    size_t xL = drawCanvas.getSize().x,
-            yL = drawCanvas.getSize().y,
-            x;
-    sf::Color pixColor;
-
-    for(size_t y = boundaries.top; y < boundaries.top + boundaries.height; ++y){
-        if((y < 0) || (y >= yL)) continue;
-        for(x = boundaries.left; x < boundaries.left + boundaries.width; ++x){
-            if((x < 0) || (x >= xL)) continue;
-            drawCanvas.setPixel(x, y, color);
-        }
+    if(clear){
+        setImageColor(highlightLayer.getImage(), sf::Color::Transparent);
+        highlightLayer.markDirty();
     }
 
-    highlightLayer.loadFromImage(drawCanvas);
+    fill(imageSpan(highlightLayer.getImage()).clip(boundaries), color);
+    highlightLayer.markDirty(boundaries);
 }
 
 void CVSketchPanel::clear_highlight(){
-    drawCanvas.create(layers.front().getSize().x,
-                      layers.front().getSize().y,
-                      sf::Color::Transparent);
-    highlightLayer.loadFromImage(drawCanvas);
+    highlightLayer.reset(sf::Vector2u(layers.front().getSize()), sf::Color::Transparent);
 }
 
 CVSketchPanel::CVSketchLayer::CVSketchLayer(CVSketchPanel* host, const sf::Vector2f& position,
@@ -440,22 +588,93 @@ CVSketchPanel::CVSketchLayer::CVSketchLayer(CVSketchPanel* host, const sf::Vecto
     bVisible(true){
 
         setPosition(position);
-        host->drawCanvas.create((unsigned int)size.x, (unsigned int)size.y, background);
-        cachedTexture.loadFromImage(host->drawCanvas);
+        reset(sf::Vector2u(size), background);
         setTexture(&cachedTexture);
 
 }
 
 sf::Vector2u CVSketchPanel::CVSketchLayer::getImageSize() const{
-    return cachedTexture.getSize();
+    return canvas.getSize();
 }
 
 void CVSketchPanel::CVSketchLayer::loadFromImage(const sf::Image& img){
-    cachedTexture.loadFromImage(img);
+    canvas = img;
+    cachedTexture.loadFromImage(canvas);
+    dirtyRects.clear();
 }
 
 void CVSketchPanel::CVSketchLayer::getTextureImage(sf::Image& output) const{
-    output = cachedTexture.copyToImage();
+    output = canvas;
+}
+
+void CVSketchPanel::CVSketchLayer::reset(const sf::Vector2u& size, const sf::Color& background){
+    if(canvas.getSize() == size){
+        setImageColor(canvas, background);
+        markDirty();
+    }
+    else{
+        canvas.create(size.x, size.y, background);
+        cachedTexture.loadFromImage(canvas);
+        dirtyRects.clear();
+    }
+}
+
+void CVSketchPanel::CVSketchLayer::markDirty(const sf::IntRect& region){
+    const sf::IntRect clipped = clipToImage(region, canvas.getSize());
+    if((clipped.width <= 0) || (clipped.height <= 0)) return;
+
+    // Fold into the last rect when their bounds waste no more than the two
+    // apart would, as for consecutive bands of a stroke
+
+    if(!dirtyRects.empty()){
+        const sf::IntRect merged = mergeRects(dirtyRects.back(), clipped);
+        if(merged.width*merged.height <= dirtyRects.back().width*dirtyRects.back().height +
+                                          clipped.width*clipped.height){
+            dirtyRects.back() = merged;
+            return;
+        }
+    }
+
+    if(dirtyRects.size() >= maxDirtyRects){
+        sf::IntRect bounds = clipped;
+        for(auto& rect : dirtyRects){
+            bounds = mergeRects(bounds, rect);
+        }
+        dirtyRects.assign(1, bounds);
+        return;
+    }
+
+    dirtyRects.push_back(clipped);
+}
+
+void CVSketchPanel::CVSketchLayer::markDirty(const std::vector<sf::IntRect>& regions){
+    for(auto& region : regions){
+        markDirty(region);
+    }
+}
+
+void CVSketchPanel::CVSketchLayer::markDirty(){
+    markDirty(sf::IntRect(0, 0, canvas.getSize().x, canvas.getSize().y));
+}
+
+void CVSketchPanel::CVSketchLayer::flush(){
+    for(auto& dirtyRect : dirtyRects){
+        const CVImageSpan region = imageSpan(canvas).clip(dirtyRect);
+
+        if(region.width == canvas.getSize().x){ // Whole rows are already contiguous
+            cachedTexture.update(region.pixels, region.width, region.height,
+                                 dirtyRect.left, dirtyRect.top);
+        }
+        else{
+            uploadBuffer.resize(size_t(region.width)*region.height*4);
+            blit(CVImageSpan(uploadBuffer, region.width, region.height), region, 0, 0);
+
+            cachedTexture.update(uploadBuffer.data(), region.width, region.height,
+                                 dirtyRect.left, dirtyRect.top);
+        }
+    }
+
+    dirtyRects.clear();
 }
 
 void CVSketchPanel::setPosition(const sf::Vector2f& position){
@@ -484,9 +703,15 @@ bool CVSketchPanel::draw(sf::RenderTarget* target){
 
     CV_DRAW_CLIP_BEGIN
 
+    // One upload per layer for everything drawn since the last frame
+
     for(auto& layer : layers){
+        layer.flush();
         target->draw(layer);
     }
+    selectionLayer.flush();
+    highlightLayer.flush();
+
     target->draw(selectionLayer);
     target->draw(highlightLayer);
 
@@ -533,16 +758,18 @@ bool CVSketchPanel::update(CVEvent& event, const sf::Vector2f& mousePos){
         brushes[selected_brush].setPosition(mousePos);
     }
 
+    if(!event.LMBhold && !event.RMBhold) bStroking = false;
+
     if(bounds.contains(mousePos) &&
        event.focusFree() && !layers.empty()){
 
         if(layers.front().getGlobalBounds().contains(mousePos)){
             brushes[selected_brush].setVisible(true);
-            View->viewPort->setMouseCursorVisible(false);
+            if(View->viewPort) View->viewPort->setMouseCursorVisible(false);
         }
         else{
             brushes[selected_brush].setVisible(false);
-            View->viewPort->setMouseCursorVisible(true);
+            if(View->viewPort) View->viewPort->setMouseCursorVisible(true);
         }
 
         if(((event.LMBhold && bounds.contains(event.LMBpressPosition)) ||
@@ -559,26 +786,30 @@ bool CVSketchPanel::update(CVEvent& event, const sf::Vector2f& mousePos){
                 event.mouse_capture(highlightLayer);
 
             }
-            else if(bCanDraw){
+            else if(bCanDraw && (selected_layer < layers.size())){
 
-                // Draw
+                // Draw, continuing the stroke from the last frame's position
 
-                if(mousePos == event.lastFrameMousePosition){
-                    draw_to_layer(selected_layer, sf::Vector2i((mousePos - layers[selected_layer].getPosition())/
-                                                               layers[selected_layer].getScale()));
+                if(!bStroking){
+                    stroke_color = event.LMBhold ? brushes[selected_brush].getPrimaryColor() :
+                                                   brushes[selected_brush].getSecondaryColor();
                 }
-                else{
-                    vMatrix<int> coords;
-                    sf::Vector2i start((event.lastFrameMousePosition - layers[selected_layer].getPosition()) /
-                                       layers[selected_layer].getScale()),
-                                    end((mousePos - layers[selected_layer].getPosition()) /
-                                        layers[selected_layer].getScale());
-                    _2Dpath(coords, std::vector<int>({ start.x, start.y }),
-                                std::vector<int>({ end.x, end.y }));
-                    draw_to_layer(selected_layer, coords);
+
+                if(!bStroking || (mousePos != event.lastFrameMousePosition)){
+                    const CVSketchLayer& layer = layers[selected_layer];
+                    const sf::Vector2f end((mousePos - layer.getPosition())/layer.getScale()),
+                                       start = bStroking ? sf::Vector2f((event.lastFrameMousePosition - layer.getPosition())/
+                                                                        layer.getScale()) : end;
+
+                    stroke_layer(selected_layer, start, end, stroke_color, bStroking);
                 }
+
+                bStroking = true;
             }
         }
+        else{
+            bStroking = false;
+        }
 
         // Scale
 
@@ -626,7 +857,7 @@ bool CVSketchPanel::update(CVEvent& event, const sf::Vector2f& mousePos){
             !layers.front().getGlobalBounds().contains(mousePos) ||
             event.mouseCaptured){
         brushes[selected_brush].setVisible(false);
-        View->viewPort->setMouseCursorVisible(true);
+        if(View->viewPort) View->viewPort->setMouseCursorVisible(true);
     }
 
     return true;
@@ -48,6 +48,8 @@
 
 #include "hyper/toolkit/string.hpp"
 
+#include <typeinfo>
+
 using namespace hyperC;
 using namespace std;
 
@@ -292,6 +294,8 @@ void CVTextBox::alignText()
         text.setPosition(textPos.x, textPos.y);
         ++i;
     }
+
+    invalidate();
 }
 
 void CVTextBox::wrapText()
@@ -416,6 +420,7 @@ void CVTextBox::setTextColor(const sf::Color& newColor)
         text.setFillColor(newColor);
     }
     textInfo.textColor = newColor;
+    invalidate();
 }
 
 void CVTextBox::setTextAlignment(const uint8_t& newAlignment)
@@ -757,56 +762,58 @@ bool CVTextBox::draw(sf::RenderTarget* target)
 
     if(bDropShadow)
     {
-        target->draw(dropShadow);
+        View->renderBatch.draw(target, dropShadow);
     }
 
     if(!bSpriteOnly)
     {
         for(auto& item : panel)
         {
-            target->draw(item);
+            View->renderBatch.draw(target, item);
         }
     }
 
-    if(bMasked) target->draw(shapeMask);
+    if(bMasked) View->renderBatch.draw(target, shapeMask);
 
-    for(auto& sprite : spriteList)
-    {
-        target->draw(sprite);
-    }
+    drawSprites(target);
 
     for(auto& text : displayText)
     {
-        target->draw(text);
+        View->renderBatch.draw(target, text);
     }
 
     if(is_closable())
     {
-        closeButton->draw(target);
+        drawChild(closeButton, target);
     }
 
     if(!active)
     {
-        target->draw(inactiveMask);
+        View->renderBatch.draw(target, inactiveMask);
     }
 
     CV_DRAW_CLIP_END
 
     if(bHasShadow)
     {
-        if(View->viewPort && View->viewPort->isOpen())
+        if(View->viewPort && View->viewPort->isOpen() && !View->pipelined())
         {
-            View->viewPort->draw(shadow);
+            View->renderBatch.draw(View->viewPort, shadow);
         }
         else
         {
-            target->draw(shadow);
+            View->renderBatch.draw(target, shadow);
         }
     }
 
     return true;
 }
 
+bool CVTextBox::drawsBatched() const
+{
+    return typeid(*this) == typeid(CVTextBox);
+}
+
 bool CVTextBox::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
     if(!CVBox::update(event, mousePos)) return false;
@@ -0,0 +1,244 @@
+/** /////////////////////////////////////////////////////////////
+//
+//  CVision: the flexible cascading-style GUI library for C++
+//
+// //////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2017 - 2019 Damian Tran
+//
+// DESCRIPTION:
+//
+// CVision is a graphical user interface (GUI) library that
+// attempts to simplify and speed up the process of desktop
+// app design.  CVision incorporates a cascading structure
+// scheme that resembles the following:
+//
+// App -> View -> Panel -> Element -> Primitives/Sprites
+//
+// The subsequent connection of each "leaf" of the hierarchy
+// automatically ensures that the element will be updated,
+// drawn to the renderer, and otherwise disposed of at
+// the program's termination.
+//
+// LEGAL:
+//
+// Modification and redistribution of CVision is freely
+// permissible under any circumstances.  Attribution to the
+// Author ("Damian Tran") is appreciated but not necessary.
+//
+// CVision is an open source library that is provided to you
+// (the "User") AS IS, with no implied or explicit
+// warranties.  By using CVision, you acknowledge and agree
+// to this disclaimer.  Use of CVision in the Users's programs
+// or as a part of a derivative library is performed at
+// the User's OWN RISK.
+//
+// ACKNOWLEDGEMENTS:
+//
+// CVision makes use of SFML (Simple and Fast Multimedia Library)
+// Copyright (c) Laurent Gomila
+// See licence: www.sfml-dev.org/license.php
+//
+/////////////////////////////////////////////////////////////  **/
+
+#include "cvision/threadpool.hpp"
+
+#include <exception>
+#include <algorithm>
+
+using namespace std;
+
+namespace cvis
+{
+
+CVThreadPool::CVThreadPool(const unsigned int& threadCount):
+    bStop(false),
+    queuedTasks(0),
+    nextQueue(0)
+{
+
+    unsigned int numThreads = threadCount;
+
+    if(!numThreads)
+    {
+        numThreads = thread::hardware_concurrency();
+        if(numThreads > 1) --numThreads;
+        else numThreads = 1;
+    }
+
+    for(size_t i = 0; i < numThreads; ++i)
+    {
+        queues.emplace_back(new TaskQueue());
+    }
+
+    for(size_t i = 0; i < numThreads; ++i)
+    {
+        workers.emplace_back(&CVThreadPool::workerLoop, this, i);
+    }
+
+}
+
+CVThreadPool::~CVThreadPool()
+{
+
+    {
+        lock_guard<mutex> lock(sleepLock);
+        bStop = true;
+    }
+    sleepSignal.notify_all();
+
+    for(auto& worker : workers)
+    {
+        if(worker.joinable()) worker.join();
+    }
+
+}
+
+void CVThreadPool::push(function<void()> task)
+{
+
+    TaskQueue& queue = *queues[nextQueue++ % queues.size()];
+
+    // Count the task under the lock that publishes it, so that a pop can
+    // never decrement the count before it has been incremented
+
+    {
+        lock_guard<mutex> lock(queue.lock);
+        queue.tasks.emplace_back(move(task));
+        ++queuedTasks;
+    }
+
+    {
+        lock_guard<mutex> lock(sleepLock);  // Order with a worker between its check and its wait
+    }
+    sleepSignal.notify_one();
+
+}
+
+bool CVThreadPool::pop(const size_t& queueIndex, function<void()>& task)
+{
+
+    const size_t numQueues = queues.size();
+
+    for(size_t i = 0; i < numQueues; ++i)
+    {
+        TaskQueue& queue = *queues[(queueIndex + i) % numQueues];
+
+        lock_guard<mutex> lock(queue.lock);
+        if(queue.tasks.empty()) continue;
+
+        if(i == 0)  // Own queue: most recently pushed task
+        {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else        // Steal the oldest task from another worker
+        {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        --queuedTasks;
+        return true;
+    }
+
+    return false;
+
+}
+
+void CVThreadPool::workerLoop(const size_t& queueIndex)
+{
+
+    function<void()> task;
+
+    while(true)
+    {
+
+        if(pop(queueIndex, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleepLock);
+
+        if(bStop) break;
+
+        sleepSignal.wait(lock, [this]{ return bStop || (queuedTasks > 0); });
+
+    }
+
+}
+
+void CVThreadPool::parallelFor(const size_t& count, const function<void(const size_t&)>& task)
+{
+
+    if(!count) return;
+
+    if((count == 1) || workers.empty())
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // Runners share ownership of the batch, since one may only be popped
+    // after the caller has claimed and finished every index
+
+    shared_ptr<Batch> batch = make_shared<Batch>();
+    batch->task = &task;
+    batch->count = count;
+    batch->next = 0;
+    batch->remaining = count;
+
+    const size_t numRunners = min(count - 1, workers.size());
+    for(size_t i = 0; i < numRunners; ++i)
+    {
+        push([this, batch]()
+        {
+            runBatch(*batch);
+        });
+    }
+
+    runBatch(*batch);
+
+    {
+        unique_lock<mutex> lock(batch->lock);
+        batch->done.wait(lock, [&batch]{ return batch->remaining == 0; });
+    }
+
+    if(batch->error)
+    {
+        rethrow_exception(batch->error);
+    }
+
+}
+
+void CVThreadPool::runBatch(Batch& batch)
+{
+
+    for(size_t i = batch.next++; i < batch.count; i = batch.next++)
+    {
+        try
+        {
+            (*batch.task)(i);
+        }
+        catch(...)
+        {
+            lock_guard<mutex> lock(batch.lock);
+            if(!batch.error) batch.error = current_exception();
+        }
+
+        if(--batch.remaining == 0)
+        {
+            lock_guard<mutex> lock(batch.lock);
+            batch.done.notify_all();
+        }
+    }
+
+}
+
+}
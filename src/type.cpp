@@ -418,6 +418,11 @@ unsigned int CVTypeBox::cursor_string_position() const
     return cursorPos - i;
 }
 
+bool CVTypeBox::needsUpdate() const
+{
+    return CVTextBox::needsUpdate() || bTypeStringChanged;   // Text set programmatically is laid out in update()
+}
+
 bool CVTypeBox::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
@@ -1275,6 +1280,7 @@ bool CVTypeBox::update(CVEvent& event, const sf::Vector2f& mousePos)
                     newFill.a = 255_BIT*(1.0f-timeLastBlink/blinkFreq);
                 }
                 cursor.setFillColor(newFill);
+                invalidate();
             }
             break;
         }
@@ -1296,13 +1302,22 @@ bool CVTypeBox::update(CVEvent& event, const sf::Vector2f& mousePos)
                 {
                     newFill.a = 255_BIT;
                 }
-                cursor.setFillColor(newFill);
+                if(newFill != cursor.getFillColor())
+                {
+                    cursor.setFillColor(newFill);
+                    invalidate();
+                }
             }
             break;
         }
         }
 
         timeLastBlink += event.lastFrameTime;
+
+        if(View->eventDriven() && (animType != CV_CURSOR_ANIM_FADE))
+        {
+            View->scheduleFrame(blinkFreq - timeLastBlink);
+        }
     }
 
     if(bTypeStringChanged)
@@ -1935,6 +1950,24 @@ void CVTextLog::shiftMsgs(const float& dist)
     scroll_bar->scroll(dist);
 }
 
+bool CVTextLog::needsUpdate() const
+{
+    if(CVTextBox::needsUpdate() || bClear || !waitingText.empty())
+    {
+        return true;    // Queued messages are posted on a delay from update()
+    }
+
+    for(auto& panel : msgPanels)
+    {
+        if(panel->needsUpdate())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool CVTextLog::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
@@ -2670,7 +2703,7 @@ void CVTextLog::replaceLastMessage(const string& search,
 
 bool CVTextLog::draw(sf::RenderTarget* target)
 {
-    if(View->viewPort == nullptr) return false;
+    if(!View->window_open()) return false;
     if(!visible) return false;
 
     CV_DRAW_CLIP_BEGIN
@@ -2679,10 +2712,7 @@ bool CVTextLog::draw(sf::RenderTarget* target)
     {
         target->draw(item);
     }
-    for(auto& sprite : spriteList)
-    {
-        target->draw(sprite);
-    }
+    drawSprites(target);
     for(auto& panel : msgPanels)
     {
         if(bounds.intersects(panel->getGlobalBounds()))
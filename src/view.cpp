@@ -44,6 +44,9 @@
 #include "cvision/view.hpp"
 #include "cvision/app.hpp"
 #include "cvision/viewpanel.hpp"
+#include "cvision/threadpool.hpp"
+
+#include <SFML/OpenGL.hpp>
 
 #if defined _WIN32 || defined _WIN32 || defined WIN32
 
@@ -325,6 +328,23 @@ CVView::CVView(unsigned int x, unsigned int y, string winName,
     bCursorOverride(false),
     bMaximized(false),
     bMinimized(false),
+    bDirtyTracking(false),
+    bEventDriven(false),
+    bHeldEvent(false),
+    bPipelined(false),
+    bFrameReady(false),
+    bPresenting(false),
+    bParallelUpdate(false),
+    bScheduled(false),
+    bLastFrameDirty(true),
+    bDirty(true),
+    bIdle(false),
+    bWakeRequested(false),
+    wakeDeadline(chrono::high_resolution_clock::time_point::max()),
+    renderThread(nullptr),
+    frameRecorded{false, false},
+    frontBuffer(0),
+    recordRetryFrame(0),
     defaultViewScale(1920.0f*1080.0f),
     backgroundColor(backgroundColor),
     OS_cursor_type(sf::Cursor::Arrow),
@@ -333,10 +353,18 @@ CVView::CVView(unsigned int x, unsigned int y, string winName,
     style(style),
     appThread(nullptr),
     frameRateLimit(mainApp->frameRate),
+    frameIndex(0),
+    skippedFrames(0),
+    inputDrainFrame(SIZE_MAX),
     frameRate(0.0f),
     width(x), height(y),
     titleBarHeight(0.0f),
     viewHeight(height),
+    physicsStep(1.0f/60),
+    physicsAccumulator(0.0f),
+    physicsAlpha(0.0f),
+    physicsSteps(0),
+    maxPhysicsSteps(5),
     resizeTarget(width, height),
     resizeSpeed(0,0),
     velocity(0,0),
@@ -352,6 +380,24 @@ CVView::CVView(unsigned int x, unsigned int y, string winName,
 void CVView::init()
 {
 
+    if(!open()) return;
+
+    while(frame())
+    {
+        if(bEventDriven && !bLastFrameDirty && idle())
+        {
+            waitForActivity();
+            resumeFrameClock();
+        }
+    }
+
+    finish();
+
+}
+
+bool CVView::open()
+{
+
     cout << "Initializing CVView\n";
 
     sf::ContextSettings contextSettings;
@@ -369,19 +415,17 @@ void CVView::init()
 
     cursor_rep.loadFromSystem(sf::Cursor::Arrow);
 
-    viewPort->setVerticalSyncEnabled(true);
-    viewPort->setMouseCursor(cursor_rep);
-    viewPort->setFramerateLimit(frameRateLimit);
+    // Scheduled views are paced by the app scheduler: per-window v-sync
+    // and frame rate limits would serialize the views sharing its thread
 
-    const float frameTime = 0.5f/frameRateLimit;
+    viewPort->setVerticalSyncEnabled(!bScheduled);
+    viewPort->setMouseCursor(cursor_rep);
+    viewPort->setFramerateLimit(bScheduled ? 0 : frameRateLimit);
 
     moveTarget = viewPort->getPosition();
-    sf::Vector2i intPos;
-
-    chrono::high_resolution_clock::time_point t0 = TIME_NOW;
-    const chrono::duration<float> frameUpdateLatency(frameTime);
 
-    chrono::duration<float> duration;
+    frameStart = TIME_NOW;
+    nextFrameTime = frameStart;
 
     cout << "Initializing event tracer\n";
 
@@ -394,51 +438,197 @@ void CVView::init()
 
     cout << "Main sequence\n";
 
-    while(!bClosed)
+    return viewPort->isOpen();
+
+}
+
+bool CVView::frame()
+{
+
+    if(bClosed) return false;
+
+    // Count actual frame time
+
+    const chrono::high_resolution_clock::time_point frameTime = TIME_NOW;
+
+    eventTrace.lastFrameTime = chrono::duration<float>(frameTime - frameStart).count();
+    frameStart = frameTime;
+
+    profiler.beginFrame();
+
+    if(bPipelined != bPresenting)   // Start or stop the render thread at a frame boundary
     {
+        if(bPipelined) startRenderThread();
+        else stopRenderThread();
+    }
 
-        if(!preDrawProcess()) break;
+    if(!preDrawProcess()) return false;
 
-        if(forceClose)
-        {
+    if(forceClose)
+    {
 
-            viewPort->close();
+        stopRenderThread();
+        viewPort->close();
 
-            break;
+        return false;
+    }
+
+    if(!replayInputFrame())
+    {
+        const sf::Vector2i intPos = sf::Mouse::getPosition(*viewPort);
+        {
+            unique_lock<mutex> lock(drawLock, defer_lock);
+            if(bPresenting) lock.lock();    // The render thread sets the window's view while replaying
+            mousePos = viewPort->mapPixelToCoords(intPos);
         }
 
-        intPos = sf::Mouse::getPosition(*viewPort);
-        mousePos = viewPort->mapPixelToCoords(intPos);
+        inputQueue.beginFrame(eventTrace.lastFrameTime, intPos,
+                              sf::Mouse::getPosition(), hasViewFocus());
+    }
+
+    bool bContextActive;
 
-        if(mainApp->setContextActive()) // Activate the background context for texture updates
+    if(bScheduled && !bPresenting)
+    {
+        bContextActive = viewPort->setActive(true); // A single context switch serves both update and draw
+    }
+    else
+    {
+        bContextActive = mainApp->setContextActive(); // Activate the background context for texture updates
+    }
+
+    if(bContextActive)
+    {
+        CV_PROFILE_SCOPE(profiler, "update", "view");
+        update(eventTrace, mousePos);
+    }
+
+    if(bClosed) return false;
+
+    bLastFrameDirty = bDirty.exchange(false);
+
+    if(bDirtyTracking && !bLastFrameDirty)
+    {
+        // Nothing was invalidated: keep the last presented frame and
+        // sleep out the remainder of the frame, since display() is
+        // what normally enforces the frame rate limit
+
+        ++skippedFrames;
+
+        const chrono::duration<float> duration = TIME_NOW - frameStart;
+        if(!bScheduled && frameRateLimit && (duration.count() < 1.0f/frameRateLimit))
         {
-            update(eventTrace, mousePos);
+            this_thread::sleep_for(chrono::duration<float>(1.0f/frameRateLimit) - duration);
         }
+    }
+    else if(bPresenting)
+    {
+        // Pipelined: the render thread presents this frame while
+        // the next update runs
 
-        if(bClosed) break;
-
-        if(viewPort->setActive(true))   // Activate the viewport context for draw
+        CV_PROFILE_SCOPE(profiler, "draw", "view");
+        submitFrame();
+    }
+    else if(viewPort->setActive(true))   // Activate the viewport context for draw
+    {
         {
+            CV_PROFILE_SCOPE(profiler, "draw", "view");
             viewPort->clear(backgroundColor);
             draw(viewPort);
-            viewPort->display();
         }
+        CV_PROFILE_SCOPE(profiler, "display", "view");
+        viewPort->display();
+    }
 
-        postDrawProcess();
+    postDrawProcess();
 
-        nextFrame:;
+    profiler.endFrame(); // Idle time is not attributed to the frame
 
-        // Count actual frame time
+    frameRate = 1.0f/eventTrace.avgFrameTime;
 
-        duration = TIME_NOW - t0;
+    ++frameIndex;
 
-        eventTrace.lastFrameTime = chrono::duration<float>(TIME_NOW - t0).count();
-        t0 = TIME_NOW;
-        frameRate = 1.0f/eventTrace.avgFrameTime;
+    return true;
 
-    }
+}
+
+void CVView::finish()
+{
+
+    profiler.endFrame();
+
+    stopRenderThread();
 
     if(viewPort && viewPort->isOpen()) viewPort->close();
+
+}
+
+void CVView::resumeFrameClock()
+{
+    // Resume as if a single frame had elapsed so that
+    // time-dependent updates do not jump by the idle period
+
+    frameStart = TIME_NOW;
+
+    if(frameRateLimit)
+    {
+        frameStart -= chrono::duration_cast<chrono::high_resolution_clock::duration>(
+                                chrono::duration<float>(1.0f/frameRateLimit));
+    }
+}
+
+bool CVView::awaitingActivity()
+{
+
+    // Non-blocking equivalent of waitForActivity() for the app scheduler
+
+    if(bWakeRequested.exchange(false) ||
+       !bEventDriven || bLastFrameDirty || !idle() ||
+       bClosed || forceClose || !window_open())
+    {
+        return false;
+    }
+
+    if(pollWindowEvent(heldEvent))
+    {
+        bHeldEvent = true;
+        return false;
+    }
+
+    {
+        lock_guard<mutex> lock(wakeLock);
+        if(TIME_NOW >= wakeDeadline)
+        {
+            wakeDeadline = chrono::high_resolution_clock::time_point::max();
+            return false;
+        }
+    }
+
+    resumeFrameClock();
+
+    return true;
+
+}
+
+void CVView::setPhysicsRate(const float& stepsPerSecond)
+{
+    if(stepsPerSecond <= 0.0f)
+    {
+        cout << "Warning (CVision): physics rate must be positive\n";
+        return;
+    }
+
+    physicsStep = 1.0f/stepsPerSecond;
+    physicsAccumulator = 0.0f;
+}
+
+void CVView::setFrameRateLimit(const unsigned int& limit)
+{
+    frameRateLimit = limit;
+    if(viewPort && !bScheduled)
+    {
+        viewPort->setFramerateLimit(frameRateLimit);
+    }
 }
 
 CVElement* CVView::getElementById(const string& tag)
@@ -446,6 +636,24 @@ CVElement* CVView::getElementById(const string& tag)
 
     if(tag.empty()) return nullptr;
 
+    {
+        lock_guard<mutex> lock(elementIndexLock);
+
+        auto it = elementIndex.find(tag);
+        if(it == elementIndex.end())
+        {
+            return nullptr;
+        }
+
+        if(it->second.size() == 1)
+        {
+            return it->second.front();
+        }
+    }
+
+    // Shared tags resolve as the panel search did: view panels in order, each
+    // panel before its members
+
     CVElement* output = nullptr;
 
     for(auto& panel : viewPanels)
@@ -464,6 +672,599 @@ CVElement* CVView::getElementById(const string& tag)
     }
 
     return output;
+
+}
+
+vector<CVElement*> CVView::getElementsByTag(const string& tag)
+{
+
+    lock_guard<mutex> lock(elementIndexLock);
+
+    auto it = elementIndex.find(tag);
+    if(it == elementIndex.end())
+    {
+        return vector<CVElement*>();
+    }
+
+    return it->second;
+
+}
+
+vector<CVElement*> CVView::getElementsByTagPrefix(const string& prefix)
+{
+
+    vector<CVElement*> output;
+
+    lock_guard<mutex> lock(elementIndexLock);
+
+    for(auto it = indexedTags.lower_bound(prefix);
+        (it != indexedTags.end()) && !it->compare(0, prefix.size(), prefix); ++it)
+    {
+        const vector<CVElement*>& tagged = elementIndex[*it];
+        output.insert(output.end(), tagged.begin(), tagged.end());
+    }
+
+    return output;
+
+}
+
+void CVView::indexElement(CVElement* element)
+{
+
+    if(!element || element->bIndexed) return;
+
+    element->bIndexed = true;
+    indexTag(element->tag(), element);
+
+    CVViewPanel* panel = dynamic_cast<CVViewPanel*>(element);
+    if(panel)
+    {
+        for(auto& item : panel->getElements())
+        {
+            indexElement(item);
+        }
+    }
+
+}
+
+void CVView::unindexElement(CVElement* element)
+{
+
+    if(!element || !element->bIndexed) return;
+
+    element->bIndexed = false;
+    unindexTag(element->tag(), element);
+
+    CVViewPanel* panel = dynamic_cast<CVViewPanel*>(element);
+    if(panel)
+    {
+        for(auto& item : panel->getElements())
+        {
+            unindexElement(item);
+        }
+    }
+
+}
+
+void CVView::indexTag(const string& tag, CVElement* element)
+{
+
+    if(tag.empty()) return;
+
+    lock_guard<mutex> lock(elementIndexLock);
+
+    vector<CVElement*>& tagged = elementIndex[tag];
+    if(tagged.empty())
+    {
+        indexedTags.insert(tag);
+    }
+    tagged.push_back(element);
+
+}
+
+void CVView::unindexTag(const string& tag, CVElement* element)
+{
+
+    if(tag.empty()) return;
+
+    lock_guard<mutex> lock(elementIndexLock);
+
+    auto it = elementIndex.find(tag);
+    if(it == elementIndex.end()) return;
+
+    vector<CVElement*>& tagged = it->second;
+    for(size_t i = 0; i < tagged.size(); ++i)
+    {
+        if(tagged[i] == element)
+        {
+            tagged.erase(tagged.begin() + i);
+            break;
+        }
+    }
+
+    if(tagged.empty())
+    {
+        elementIndex.erase(it);
+        indexedTags.erase(tag);
+    }
+
+}
+
+void CVView::setDirtyTracking(const bool& state)
+{
+    bDirtyTracking = state;
+    invalidate();
+}
+
+void CVView::setEventDriven(const bool& state)
+{
+    bEventDriven = state;
+    wake();
+}
+
+void CVView::setPipelined(const bool& state)
+{
+    bPipelined = state;
+    wake();
+}
+
+void CVView::setParallelUpdate(const bool& state)
+{
+    bParallelUpdate = state;
+}
+
+// Could this panel capture the mouse or focus during this frame's update?
+
+static bool mayClaim(CVElement* element, const CVEvent& event, const sf::Vector2f& mousePos)
+{
+    const sf::FloatRect bounds = element->getBounds();
+
+    return bounds.contains(mousePos) ||
+            ((event.LMBhold || event.LMBreleased) && bounds.contains(event.LMBpressPosition)) ||
+            ((event.RMBhold || event.RMBreleased) && bounds.contains(event.RMBpressPosition)) ||
+            event.isCaptured(*element);
+}
+
+void CVView::updateIndependent(vector<CVElement*>& batch, CVEvent& event,
+                               const sf::Vector2f& mousePos, CVElement* container)
+{
+
+    if(batch.empty()) return;
+
+    vector<CVElement*> run;
+
+    for(auto& element : batch)
+    {
+        if(mayClaim(element, event, mousePos))
+        {
+            updateParallel(run, event, mousePos, container);
+
+            CV_PROFILE_ELEMENT(profiler, element, "update");
+            element->update(event, mousePos);
+        }
+        else
+        {
+            run.push_back(element);
+        }
+    }
+
+    updateParallel(run, event, mousePos, container);
+
+    batch.clear();
+
+}
+
+void CVView::updateParallel(vector<CVElement*>& batch, CVEvent& event,
+                            const sf::Vector2f& mousePos, CVElement* container)
+{
+
+    if(batch.empty()) return;
+
+    if(batch.size() == 1)
+    {
+        CV_PROFILE_ELEMENT(profiler, batch.front(), "update");
+        batch.front()->update(event, mousePos);
+        batch.clear();
+        return;
+    }
+
+    CV_PROFILE_SCOPE(profiler, "parallel update", "update");
+
+    // Resolve stale bounds here so that reads from the workers never write
+
+    if(container) container->refreshBounds();
+    for(auto& element : batch)
+    {
+        element->refreshBounds();
+    }
+
+    const CVEvent base(event);
+    vector<CVEvent> results(batch.size(), base);
+    vector<char> boundaryReached(batch.size(), false),
+                 boundsReached(batch.size(), false);
+
+    vector<sf::FloatRect> lastBounds(batch.size());
+    for(size_t i = 0; i < batch.size(); ++i)
+    {
+        lastBounds[i] = batch[i]->getBounds();
+    }
+
+    mainApp->threadPool().parallelFor(batch.size(), [&](const size_t& i)
+    {
+        CVInvalidationBoundary boundary(container);
+        batch[i]->update(results[i], mousePos);
+        boundaryReached[i] = boundary.reached();
+        boundsReached[i] = boundary.boundsReached();
+    });
+
+    bool bContainerDirty = false,
+         bContainerBoundsDirty = false;
+
+    for(size_t i = 0; i < batch.size(); ++i)
+    {
+        event.mergeChanges(base, results[i]);
+        if(boundaryReached[i]) bContainerDirty = true;
+        if(boundsReached[i] ||
+           (!batch[i]->boundsDirty() && (batch[i]->getBounds() != lastBounds[i])))  // Written without invalidate()
+        {
+            bContainerBoundsDirty = true;
+        }
+    }
+
+    if(container)
+    {
+        if(bContainerBoundsDirty) container->invalidateBounds();
+        if(bContainerDirty) container->invalidate();
+    }
+
+    batch.clear();
+
+}
+
+void CVView::startRenderThread()
+{
+
+    if(renderThread || !window_open()) return;
+
+    viewPort->setActive(false); // Release the window context to the render thread
+
+    bFrameReady = false;
+    bPresenting = true;
+
+    renderThread = new thread(&CVView::renderLoop, this);
+
+}
+
+void CVView::stopRenderThread()
+{
+
+    if(!renderThread) return;
+
+    {
+        lock_guard<mutex> lock(frameLock);
+        bPresenting = false;
+    }
+    frameSignal.notify_all();
+
+    renderThread->join();
+    delete(renderThread);
+    renderThread = nullptr;
+
+    bFrameReady = false;
+
+    invalidate();   // The last submitted frame may not have been presented
+
+}
+
+static const size_t frameRecordRetryInterval = 60;     // Frames to rasterise after one that could not be recorded
+
+void CVView::submitFrame()
+{
+
+    unsigned int backBuffer;
+
+    {
+        // Hold at most one completed frame in flight
+
+        unique_lock<mutex> lock(frameLock);
+        frameSignal.wait(lock, [this]{ return !bFrameReady || !bPresenting; });
+
+        backBuffer = 1 - frontBuffer;
+    }
+
+    const sf::Vector2u size = viewPort->getSize();
+
+    if(!size.x || !size.y) return;
+
+    sf::View windowView;
+    {
+        lock_guard<mutex> lock(drawLock);   // The render thread sets the window's view while replaying
+        windowView = viewPort->getView();
+    }
+
+    // Record the frame as a draw list, leaving all GL submission to the
+    // render thread.  Elements that draw outside the batch cannot be
+    // recorded, so such frames are rasterised here instead.
+
+    bool bRecorded = false;
+
+    if(frameIndex >= recordRetryFrame)
+    {
+        frameLists[backBuffer].clear();
+        frameRecorder.reset(size, windowView);
+
+        if(renderBatch.record(&frameRecorder, &frameLists[backBuffer]))
+        {
+            draw(&frameRecorder);
+            renderBatch.end();
+
+            bRecorded = frameRecorder.complete();
+        }
+
+        if(!bRecorded)
+        {
+            recordRetryFrame = frameIndex + frameRecordRetryInterval;
+        }
+    }
+
+    if(!bRecorded)
+    {
+        sf::RenderTexture& buffer = frameBuffers[backBuffer];
+
+        if(buffer.getSize() != size)
+        {
+            if(!buffer.create(size.x, size.y))
+            {
+                cout << "Warning (CVision): unable to create frame buffer for pipelined rendering\n";
+                return;
+            }
+        }
+
+        if(!buffer.setActive(true)) return;
+
+        buffer.setView(windowView);
+        buffer.clear(backgroundColor);
+        draw(&buffer);
+        buffer.display();
+
+        const sf::Vector2f topLeft = buffer.mapPixelToCoords(sf::Vector2i(0, 0));
+        const sf::Vector2f bottomRight = buffer.mapPixelToCoords(sf::Vector2i(size));
+
+        frameRects[backBuffer] = sf::FloatRect(topLeft, bottomRight - topLeft);
+    }
+
+    // Submit this context's texture uploads (glyphs, lazy loads) and the
+    // frame buffer before the render thread binds them from its context
+
+    glFlush();
+
+    {
+        lock_guard<mutex> lock(frameLock);
+        frameRecorded[backBuffer] = bRecorded;
+        frontBuffer = backBuffer;
+        bFrameReady = true;
+    }
+    frameSignal.notify_all();
+
+}
+
+void CVView::renderLoop()
+{
+
+    viewPort->setActive(true);
+
+    while(true)
+    {
+
+        unsigned int index;
+        bool bRecorded;
+
+        {
+            unique_lock<mutex> lock(frameLock);
+            frameSignal.wait(lock, [this]{ return bFrameReady || !bPresenting; });
+
+            if(!bPresenting) break;
+
+            index = frontBuffer;
+            bRecorded = frameRecorded[index];
+            bFrameReady = false;
+        }
+        frameSignal.notify_all();
+
+        drawLock.lock();
+
+        viewPort->resetGLStates();  // Rebind textures written from the update thread's context
+        viewPort->clear(backgroundColor);
+
+        if(bRecorded)
+        {
+            frameLists[index].replay(*viewPort);
+        }
+        else
+        {
+            const sf::Texture& texture = frameBuffers[index].getTexture();
+
+            sf::Sprite frame(texture);
+            frame.setPosition(frameRects[index].left, frameRects[index].top);
+            frame.setScale(frameRects[index].width/texture.getSize().x,
+                           frameRects[index].height/texture.getSize().y);
+
+            viewPort->draw(frame);
+        }
+
+        drawLock.unlock();
+
+        viewPort->display();    // Blocks for v-sync and the frame rate limit off the update thread
+
+    }
+
+    viewPort->setActive(false);
+
+}
+
+bool CVView::pollWindowEvent(sf::Event& event)
+{
+    if(bPresenting)
+    {
+        lock_guard<mutex> lock(drawLock);
+        return viewPort->pollEvent(event);
+    }
+
+    return viewPort->pollEvent(event);
+}
+
+void CVView::wake()
+{
+    bWakeRequested = true;
+    wakeSignal.notify_all();
+}
+
+void CVView::scheduleFrame(const float& delay)
+{
+    const chrono::high_resolution_clock::time_point deadline = TIME_NOW +
+        chrono::duration_cast<chrono::high_resolution_clock::duration>(chrono::duration<float>(delay));
+
+    lock_guard<mutex> lock(wakeLock);
+    if(deadline < wakeDeadline)
+    {
+        wakeDeadline = deadline;
+    }
+}
+
+bool CVView::idle() const
+{
+    return pendingAnims.empty() &&
+            !eventTrace.LMBhold &&
+            !eventTrace.RMBhold &&
+            !bDirty &&
+            !bWakeRequested &&
+            !bHeldEvent;
+}
+
+void CVView::waitForActivity()
+{
+
+    // Equivalent to sf::Window::waitEvent, which polls in 10 ms slices,
+    // but the slices sleep on a condition variable so that other threads
+    // (pushEvent, triggers, invalidate) can interrupt the wait
+
+    const chrono::milliseconds pollInterval(10);
+
+    bIdle = true;
+
+    while(!bClosed && !forceClose &&
+          !bWakeRequested && !bDirty &&
+          window_open())
+    {
+        if(pollWindowEvent(heldEvent))
+        {
+            bHeldEvent = true;
+            break;
+        }
+
+        unique_lock<mutex> lock(wakeLock);
+
+        const chrono::high_resolution_clock::time_point now = TIME_NOW;
+        if(now >= wakeDeadline)
+        {
+            break;
+        }
+
+        if(wakeDeadline - now < pollInterval)
+        {
+            wakeSignal.wait_until(lock, wakeDeadline);
+        }
+        else
+        {
+            wakeSignal.wait_for(lock, pollInterval);
+        }
+    }
+
+    bIdle = false;
+    bWakeRequested = false;
+
+    lock_guard<mutex> lock(wakeLock);
+    if(TIME_NOW >= wakeDeadline)
+    {
+        wakeDeadline = chrono::high_resolution_clock::time_point::max();
+    }
+
+}
+
+bool CVView::pollViewEvent(sf::Event& event)
+{
+
+    if(inputQueue.replaying())
+    {
+        // Live input is ignored during replay, except a request to close
+
+        sf::Event liveEvent;
+        while(pollWindowEvent(liveEvent))
+        {
+            if(liveEvent.type == sf::Event::Closed)
+            {
+                event = liveEvent;
+                return true;
+            }
+        }
+    }
+    else if(inputDrainFrame != frameIndex)  // Drain the OS queue once per frame
+    {
+        inputDrainFrame = frameIndex;
+
+        if(bHeldEvent)
+        {
+            inputQueue.push(heldEvent);
+            bHeldEvent = false;
+        }
+
+        sf::Event liveEvent;
+        while(pollWindowEvent(liveEvent))
+        {
+            inputQueue.push(liveEvent);
+        }
+    }
+
+    return inputQueue.pop(event);
+
+}
+
+bool CVView::replayInputFrame()
+{
+
+    if(!inputQueue.replaying()) return false;
+
+    const CVInputFrame* sample = inputQueue.nextFrame();
+    if(!sample) return false;   // Replay complete: resume live input
+
+    eventTrace.lastFrameTime = sample->frameTime;
+
+    unique_lock<mutex> lock(drawLock, defer_lock);
+    if(bPresenting) lock.lock();
+
+    mousePos = viewPort ? viewPort->mapPixelToCoords(sample->mousePosition) :
+                            sf::Vector2f(sample->mousePosition);
+
+    return true;
+
+}
+
+bool CVView::hasViewFocus() const
+{
+    if(inputQueue.replayFrame())
+    {
+        return inputQueue.replayFrame()->focus;
+    }
+    return viewPort && viewPort->hasFocus();
+}
+
+sf::Vector2f CVView::getGlobalMousePosition() const
+{
+    if(inputQueue.replayFrame())
+    {
+        return sf::Vector2f(inputQueue.replayFrame()->globalMousePosition);
+    }
+    return sf::Vector2f(sf::Mouse::getPosition());
 }
 
 void CVView::activateWindow()
@@ -563,6 +1364,12 @@ const sf::Texture* CVView::appTexture(const string& tag) const
     return nullptr;
 }
 
+CVTextureRegion CVView::appTextureRegion(const string& tag) const
+{
+    if(mainApp) return mainApp->bitmaps.textureRegion(tag);
+    return { nullptr, sf::IntRect() };
+}
+
 const sf::Image* CVView::appImage(const string& tag) const
 {
     if(mainApp) return mainApp->bitmaps.taggedImage(tag);
@@ -611,11 +1418,13 @@ void CVView::setState(uint8_t newState)
     }
 
     viewState = newState;
+    invalidate();
 
 }
 
 void CVView::setCursor(const sf::Cursor::Type& newCursor)
 {
+    if(!viewPort) return;
     cursor_rep.loadFromSystem(newCursor);
     viewPort->setMouseCursor(cursor_rep);
 }
@@ -631,7 +1440,8 @@ void CVView::setCursor(const sf::Texture* texture,
     cursor.setScale(size/texture->getSize());
     cursor.setColor(fillColor);
     bCursorOverride = true;
-    viewPort->setMouseCursorVisible(false);
+    if(viewPort) viewPort->setMouseCursorVisible(false);
+    invalidate();
 
 }
 
@@ -650,7 +1460,8 @@ void CVView::setCursor(const string& texture,
 void CVView::clearCursor()
 {
     bCursorOverride = false;
-    viewPort->setMouseCursorVisible(true);
+    if(viewPort) viewPort->setMouseCursorVisible(true);
+    invalidate();
 }
 
 void CVView::setShadow(CVElement& element,
@@ -666,6 +1477,7 @@ void CVView::setShadow(CVElement& element,
     shadow.setColor(sf::Color(255,255,255,alpha));
 
     bShadow = true;
+    invalidate();
 }
 
 void CVView::setShadow(const sf::Texture* texture,
@@ -705,6 +1517,7 @@ void CVView::setShadow(const string& texture,
 void CVView::clearShadow()
 {
     bShadow = false;
+    invalidate();
 }
 
 bool CVView::contains(const CVElement& element)
@@ -746,6 +1559,8 @@ void CVView::addPanel(CVViewPanel* newPanel, string tag, const unsigned int& ind
             newPanel->setTag("Panel " + to_string(viewPanels.size()));
             panelTags.push_back(newPanel->tag());
         }
+        indexElement(newPanel);
+        invalidate();
     }
 }
 
@@ -833,6 +1648,8 @@ void CVView::setVisiblePanel(CVViewPanel* panel)
 
 void CVView::setPosition(const sf::Vector2i& position)
 {
+    if(!viewPort) return;
+
     if(parentView != nullptr)  // Relative to parent if parent exists
     {
         sf::Vector2i parentPosition(parentView->viewPort->getPosition());
@@ -845,11 +1662,13 @@ void CVView::setPosition(const sf::Vector2i& position)
 
 void CVView::setScreenPosition(sf::Vector2i newPosition)
 {
-    viewPort->setPosition(newPosition);
+    if(viewPort) viewPort->setPosition(newPosition);
 }
 
 void CVView::draw(sf::RenderTarget* target)
 {
+    renderBatch.beginFrame();
+
     switch(viewState)
     {
     case VIEW_STATE_STARTUP:
@@ -859,22 +1678,23 @@ void CVView::draw(sf::RenderTarget* target)
     case VIEW_STATE_MAIN:
     {
 
-        mainApp->setContextActive();
+        if(!bScheduled) mainApp->setContextActive();   // Scheduled views stay on the window context
 
         for(auto& item : viewPanels)
         {
             if(item->isVisible())
             {
+                CV_PROFILE_ELEMENT(profiler, item, "draw");
                 item->draw(target);
             }
         }
         if(bShadow)
         {
-            target->draw(shadow);
+            renderBatch.draw(target, shadow);
         }
         if(bCursorOverride)
         {
-            target->draw(cursor);
+            renderBatch.draw(target, cursor);
         }
 
         break;
@@ -886,6 +1706,7 @@ void CVView::draw(sf::RenderTarget* target)
 
 void CVView::stopAnim(sf::Transformable* element)
 {
+    lock_guard<mutex> lock(animLock);
     for(size_t i = 0; i < pendingAnims.size();)
     {
         if(pendingAnims[i].animObject == element)
@@ -910,7 +1731,15 @@ void CVView::sendTrigger(CVElement * target, const string& signal)
 
 bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
-    if(bClosed || (viewPort == nullptr) || !viewPort->isOpen()) return false;
+    if(bClosed || !window_open()) return false;
+
+    // Advance the fixed-step simulation clock.  Time beyond the step
+    // cap is dropped so a stalled frame cannot launch moving elements
+
+    physicsAccumulator += std::min(event.lastFrameTime, maxPhysicsSteps*physicsStep);
+    physicsSteps = std::min((unsigned int)(physicsAccumulator/physicsStep), maxPhysicsSteps);
+    physicsAccumulator -= physicsSteps*physicsStep;
+    physicsAlpha = std::min(physicsAccumulator/physicsStep, 1.0f);
 
     // Handle cursor override
 
@@ -921,7 +1750,7 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
 
     // Handle drag and drop
 
-    if(bDropable && !dropTarget)
+    if(bDropable && !dropTarget && viewPort)
     {
 
         dropTarget = new CVDropTarget(this);
@@ -962,19 +1791,71 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
     }
 
     // Handle screenshots in the main update thread
-    if(saveRequestFiles.size() > 0)
+    if(viewPort && (saveRequestFiles.size() > 0))
     {
-        sf::Texture screenshot;
-        screenshot.create(getWidth(), getHeight());
+        sf::Image capture;
+
+        if(bPresenting)
+        {
+            // The render thread owns the window's context, so redraw the
+            // last completed frame off-screen instead of reading the window
+
+            unsigned int index;
+            bool bRecorded;
+            {
+                lock_guard<mutex> frame(frameLock);
+                index = frontBuffer;
+                bRecorded = frameRecorded[index];
+            }
+
+            if(bRecorded)
+            {
+                lock_guard<mutex> lock(captureLock);
+
+                const sf::Vector2u size = viewPort->getSize();
 
-        while(saveRequestFiles.size() > 0)
+                if((textureBuffer.getSize() == size) || textureBuffer.create(size.x, size.y))
+                {
+                    textureBuffer.setActive(true);
+                    textureBuffer.clear(backgroundColor);
+                    frameLists[index].replay(textureBuffer);
+                    textureBuffer.display();
+                    capture = textureBuffer.getTexture().copyToImage();
+                }
+            }
+            else
+            {
+                lock_guard<mutex> lock(drawLock);
+
+                if(frameBuffers[index].getSize().x)
+                {
+                    capture = frameBuffers[index].getTexture().copyToImage();
+                }
+            }
+        }
+        else
         {
+            sf::Texture screenshot;
+            screenshot.create(getWidth(), getHeight());
             screenshot.update(*viewPort);
-            screenshot.copyToImage().saveToFile(saveRequestFiles.front());
-            saveRequestFiles.erase(saveRequestFiles.begin());
+            capture = screenshot.copyToImage();
+        }
+
+        if(capture.getSize().x) // Otherwise retry once a frame has been submitted
+        {
+            while(saveRequestFiles.size() > 0)
+            {
+                capture.saveToFile(saveRequestFiles.front());
+                saveRequestFiles.erase(saveRequestFiles.begin());
+            }
         }
     }
 
+    if(!pendingAnims.empty() || !saveRequestFiles.empty())
+    {
+        invalidate();
+    }
+
     for(size_t i = 0; i < pendingAnims.size();)
     {
         if(pendingAnims[i].finished())
@@ -990,7 +1871,7 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
 
     if(!handleViewEvents(event)) return false;
 
-    if(viewPort->getPosition() != moveTarget)
+    if(viewPort && (viewPort->getPosition() != moveTarget))
     {
         sf::Vector2i viewPos(viewPort->getPosition());
         if(velocity.x != 0)
@@ -1037,9 +1918,10 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
             }
         }
         viewPort->setPosition(viewPos);
+        invalidate();
     }
 
-    if(viewPort->getSize() != resizeTarget)
+    if(viewPort && (viewPort->getSize() != resizeTarget))
     {
         sf::Vector2u viewSize = viewPort->getSize();
         bool resizeFLAG = false;
@@ -1090,10 +1972,14 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
             resizeFLAG = true;
         }
 
-        if(resizeFLAG) viewPort->setSize(viewSize);
+        if(resizeFLAG)
+        {
+            viewPort->setSize(viewSize);
+            invalidate();
+        }
     }
 
-    if(bClosed || (viewPort == nullptr))
+    if(bClosed || !window_open())
     {
         close();
         return false;
@@ -1113,6 +1999,12 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
         event.releaseCapturedShapes();
     }
 
+    if((mousePos != event.lastFrameMousePosition) ||
+       event.LMBhold || event.RMBhold)
+    {
+        invalidate(); // Hover, drag and press states follow the pointer
+    }
+
     event.mouseTraceBuffer.emplace_back(mousePos);
     event.mouseTraceBuffer.erase(event.mouseTraceBuffer.begin());
 
@@ -1125,19 +2017,31 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
     // Reset the native cursor type to default
     event.awaitingCursorType = sf::Cursor::Arrow;
 
+    vector<CVElement*> independentPanels;   // Consecutive independent panels, in update order
+
     for(int i = viewPanels.size() - 1; (i >= 0) && !viewPanels.empty(); --i)
     {
         if(viewPanels[i]->shouldDelete())
         {
             delete(viewPanels[i]);
             viewPanels.erase(viewPanels.begin() + i);
+            invalidate();
+        }
+        else if(bParallelUpdate && viewPanels[i]->independentUpdate())
+        {
+            independentPanels.push_back(viewPanels[i]);
         }
         else
         {
+            updateIndependent(independentPanels, event, mousePos);
+
+            CV_PROFILE_ELEMENT(profiler, viewPanels[i], "update");
             viewPanels[i]->update(event, mousePos);
         }
     }
 
+    updateIndependent(independentPanels, event, mousePos);
+
     if(event.closed())  // Check for a close signal
     {
         bClosed = true;
@@ -1146,7 +2050,7 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
 
     if(OS_cursor_type != event.awaitingCursorType) // Only load the cursor if different from last frame
     {
-        if(!bCursorOverride)
+        if(!bCursorOverride && viewPort)
         {
             cursor_rep.loadFromSystem(event.awaitingCursorType);
             viewPort->setMouseCursor(cursor_rep);
@@ -1157,7 +2061,7 @@ bool CVView::update(CVEvent& event, const sf::Vector2f& mousePos)
     event.moveCapturedShapes();
 
     event.lastFrameMousePosition = mousePos;
-    event.lastFrameGlobalMousePosition = sf::Vector2f(sf::Mouse::getPosition());
+    event.lastFrameGlobalMousePosition = getGlobalMousePosition();
     event.timeLastKey += event.lastFrameTime;
     event.avgFrameTime *= event.numFrameAvg;
     event.avgFrameTime += event.lastFrameTime;
@@ -1198,13 +2102,15 @@ bool CVView::handleViewEvents(CVEvent& event)
     event.viewResized = false;
     event.keyPressed = false;
 
-    if((viewPort == nullptr) || (!viewPort->isOpen())) return false;
+    if(!window_open()) return false;
 
     sf::Event SFevent;
-    event.viewHasFocus = viewPort->hasFocus();
+    event.viewHasFocus = hasViewFocus();
 
-    while(viewPort->pollEvent(SFevent))
+    while(pollViewEvent(SFevent))
     {
+        invalidate(); // Any OS event may alter the visible state
+
         switch(SFevent.type)
         {
         case sf::Event::Closed:
@@ -1217,8 +2123,8 @@ bool CVView::handleViewEvents(CVEvent& event)
         {
             event.lastViewBounds = event.viewBounds;
 //            viewPort->setView(sf::View(sf::FloatRect(0, 0, SFevent.size.width, SFevent.size.height)));
-            event.viewBounds = sf::FloatRect(viewPort->getPosition().x, viewPort->getPosition().y,
-                                             viewPort->getSize().x, viewPort->getSize().y);
+            event.viewBounds = sf::FloatRect(getPosition().x, getPosition().y,
+                                             SFevent.size.width, SFevent.size.height);
             event.lastViewBounds = event.viewBounds;
             event.viewResized = true;
 
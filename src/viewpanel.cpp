@@ -44,6 +44,10 @@
 #include "cvision/viewpanel.hpp"
 #include "cvision/view.hpp"
 
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
 using namespace std;
 
 namespace cvis
@@ -68,8 +72,13 @@ CVViewPanel::CVViewPanel(CVView* parentView,
     bDragAndDrop(false),
     bOutOfBoundsDraw(false),
     bOutOfBoundsUpdate(false),
+    bIndependentUpdate(false),
     bFadeMembersOnly(false),
-    bReverseDrawOrder(false)
+    bReverseDrawOrder(false),
+    bRelativeLayout(false),
+    bBatchDraw(false),
+    contentOffset(0.0f,0.0f),
+    hitGrid(nullptr)
 {
     IDtag = panelTag;
 
@@ -89,16 +98,19 @@ CVViewPanel::~CVViewPanel()
     {
         delete(item);
     }
+    delete(hitGrid);
 }
 
 void CVViewPanel::updateBounds()
 {
+    bBoundsDirty = false;
+
     if(numPanels() > 0)
     {
-        bounds = viewPanelElements.front()->getBounds();
+        bounds = contentBounds(viewPanelElements.front());
         for(size_t i = 1; i < viewPanelElements.size(); ++i)
         {
-            expandBounds(bounds, viewPanelElements[i]->getBounds());
+            expandBounds(bounds, contentBounds(viewPanelElements[i]));
         }
 
         panel.front().setSize(sf::Vector2f(bounds.width, bounds.height));
@@ -115,33 +127,100 @@ void CVViewPanel::updateBounds()
 void CVViewPanel::updatePanels(CVEvent& event, const sf::Vector2f& mousePos)
 {
 
+    vector<CVElement*> independentPanels;   // Consecutive independent panels, in update order
+
+    // Members see the mouse and the view in their own space
+
+    const sf::Vector2f memberMousePos = mousePos - contentOffset;
+
+    sf::Vector2f viewOffset = contentOffset;
+    for(const CVViewPanel* owner = viewPanel; owner; owner = owner->viewPanel)
+    {
+        viewOffset += owner->contentOffset;
+    }
+
+    const sf::FloatRect memberViewBounds(-viewOffset.x, -viewOffset.y, View->getWidth(), View->getHeight());
+
+    if(bRelativeLayout)
+    {
+        event.translateMouse(-contentOffset);
+    }
+
+    if(hitGrid)
+    {
+        hitGrid->flush();
+
+        hitElements.clear();
+        hitGrid->query(memberMousePos, hitElements);
+        hitGrid->query(event.LMBpressPosition, hitElements);
+        sort(hitElements.begin(), hitElements.end(), less<CVElement*>());
+    }
+
     for(int i = viewPanelElements.size() - 1; (i >= 0) && !viewPanelElements.empty(); --i)
     {
         if(viewPanelElements[i]->shouldDelete())
         {
             removePanelElement(i);
         }
+        else if(hitGrid && viewPanelElements[i]->skipsWhenIdle() &&
+                !viewPanelElements[i]->needsUpdate() &&
+                !event.isCaptured(*viewPanelElements[i]) &&
+                !binary_search(hitElements.begin(), hitElements.end(), viewPanelElements[i], less<CVElement*>()))
+        {
+            continue;   // Idle and away from the cursor
+        }
         else
         {
-            if(bOutOfBoundsUpdate || View->contains(*viewPanelElements[i]))
+            if(bOutOfBoundsUpdate || memberViewBounds.intersects(viewPanelElements[i]->getBounds()))
             {
-                if(!bClipBounds || panel.front().getGlobalBounds().intersects(viewPanelElements[i]->getBounds()))
+                if(!bClipBounds || panel.front().getGlobalBounds().intersects(contentBounds(viewPanelElements[i])))
                 {
-                    viewPanelElements[i]->update(event, mousePos);
+                    if(View->parallelUpdate() && updatesIndependently(viewPanelElements[i]))
+                    {
+                        independentPanels.push_back(viewPanelElements[i]);
+                    }
+                    else
+                    {
+                        View->updateIndependent(independentPanels, event, memberMousePos, this);
+
+                        const sf::FloatRect lastBounds = viewPanelElements[i]->getBounds();
+
+                        {
+                            CV_PROFILE_ELEMENT(View->profiler, viewPanelElements[i], "update");
+                            viewPanelElements[i]->update(event, memberMousePos);
+                        }
+
+                        // Catch bounds written directly, without invalidate()
+
+                        if(bExpand && !viewPanelElements[i]->boundsDirty() &&
+                           (viewPanelElements[i]->getBounds() != lastBounds))
+                        {
+                            viewPanelElements[i]->markBoundsDirty();
+                        }
+
+                        if(hitGrid)
+                        {
+                            hitGrid->update(viewPanelElements[i]);
+                        }
+                    }
                 }
             }
         }
     }
 
+    View->updateIndependent(independentPanels, event, memberMousePos, this);
+
+    if(bRelativeLayout)
+    {
+        event.translateMouse(contentOffset);
+    }
+
 }
 
 void CVViewPanel::setExpand(const bool& state)
 {
     bExpand = state;
-    if(bExpand)
-    {
-        updateBounds();
-    }
+    invalidateBounds();
 }
 
 void CVViewPanel::addPanelElement(CVElement* newElement,
@@ -167,11 +246,23 @@ void CVViewPanel::addPanelElement(CVElement* newElement,
         viewPanelElements.emplace_back(newElement);
     }
 
-    if(bExpand)
+    if(bRelativeLayout)
+    {
+        newElement->move(-contentOffset);   // Placed in panel space, stored in member space
+    }
+
+    if(hitGrid)
+    {
+        hitGrid->insert(newElement);
+    }
+
+    if(bIndexed)
     {
-        updateBounds(); // Update the panel boundaries to accommodate if applicable
+        View->indexElement(newElement);
     }
 
+    invalidateBounds(); // Expand the panel boundaries to accommodate if applicable
+
 }
 
 void CVViewPanel::clear()
@@ -181,6 +272,11 @@ void CVViewPanel::clear()
         delete(item);
     }
     viewPanelElements.clear();
+
+    if(hitGrid)
+    {
+        hitGrid->clear();
+    }
 }
 
 bool CVViewPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
@@ -204,10 +300,7 @@ bool CVViewPanel::update(CVEvent& event, const sf::Vector2f& mousePos)
         return false;
     }
 
-    if(bExpand)
-    {
-        updateBounds();
-    }
+    refreshBounds();
 
     if(bTransduceFocus)
     {
@@ -224,6 +317,10 @@ void CVViewPanel::removePanelElement(const unsigned int& index)
 {
     if(index < numPanels())
     {
+        if(hitGrid)
+        {
+            hitGrid->remove(viewPanelElements[index]);
+        }
         delete(viewPanelElements[index]);
         viewPanelElements.erase(viewPanelElements.begin() + index);
     }
@@ -232,10 +329,7 @@ void CVViewPanel::removePanelElement(const unsigned int& index)
         throw out_of_range("In CVViewPanel::removePanelElement: index out of range of element list");
     }
 
-    if(bExpand)
-    {
-        updateBounds();
-    }
+    invalidateBounds();
 }
 
 void CVViewPanel::removePanelElement(CVElement* element)
@@ -262,7 +356,7 @@ void CVViewPanel::removePanelElement(const string& tag)
     }
 }
 
-void CVViewPanel::detachPanelElement(const CVElement* element) noexcept
+void CVViewPanel::detachPanelElement(const CVElement* element)
 {
 
     for(size_t i = 0; i < viewPanelElements.size(); ++i)
@@ -270,26 +364,92 @@ void CVViewPanel::detachPanelElement(const CVElement* element) noexcept
 
         if(viewPanelElements[i] == element)
         {
+            View->unindexElement(viewPanelElements[i]);
+            if(hitGrid)
+            {
+                hitGrid->remove(element);
+            }
+            if(bRelativeLayout)
+            {
+                viewPanelElements[i]->move(contentOffset);  // Return to panel space
+            }
             viewPanelElements.erase(viewPanelElements.begin() + i);
+            invalidateBounds();
             return;
         }
 
     }
 
-    if(bExpand)
+}
+
+void CVViewPanel::move(const sf::Vector2f& distance)
+{
+    CVTextBox::move(distance);
+    if(bRelativeLayout)
     {
-        updateBounds();
+        contentOffset += distance;
     }
+    else
+    {
+        for(auto& panel : viewPanelElements)
+        {
+            panel->move(distance);
+        }
+    }
+}
 
+void CVViewPanel::moveContent(const sf::Vector2f& distance)
+{
+    if((distance.x == 0.0f) && (distance.y == 0.0f)) return;
+
+    if(bRelativeLayout)
+    {
+        contentOffset += distance;
+        invalidateBounds();
+        invalidate();
+    }
+    else
+    {
+        for(auto& panel : viewPanelElements)
+        {
+            panel->move(distance);
+        }
+    }
 }
 
-void CVViewPanel::move(const sf::Vector2f& distance)
+bool CVViewPanel::supportsRelativeLayout() const
 {
-    CVTextBox::move(distance);
-    for(auto& panel : viewPanelElements)
+    return false;
+}
+
+void CVViewPanel::setRelativeLayout(const bool& state)
+{
+    if(state == bRelativeLayout) return;
+
+    if(state && !supportsRelativeLayout())
     {
-        panel->move(distance);
+        cout << "Warning (CVision): panel \"" << tag() << "\" places its members itself and does not support relative layout\n";
+        return;
     }
+
+    if(!state)
+    {
+        const sf::Vector2f offset = contentOffset;
+
+        bRelativeLayout = false;
+        contentOffset = sf::Vector2f(0.0f,0.0f);
+
+        for(auto& panel : viewPanelElements)
+        {
+            panel->move(offset);
+        }
+    }
+    else
+    {
+        bRelativeLayout = true;
+    }
+
+    invalidate();
 }
 
 void CVViewPanel::setPosition(const sf::Vector2f& position)
@@ -299,12 +459,21 @@ void CVViewPanel::setPosition(const sf::Vector2f& position)
 
 void CVViewPanel::setSize(const sf::Vector2f& newSize)
 {
+    // Members of a relative layout keep their offsets from the panel, so
+    // resizing touches only the panel itself
+
+    if(bRelativeLayout || (newSize == getSize()))
+    {
+        CVBox::setSize(newSize);
+        return;
+    }
+
     float scaleFactorX = getSize().x/newSize.x;
     float scaleFactorY = getSize().y/newSize.y;
 
     for(auto& item : viewPanelElements)
     {
-        sf::Vector2f dist = item->getPosition() - getPosition(),
+        sf::Vector2f dist = item->getPosition() + contentOffset - getPosition(),
                             scaleDist = dist;
         scaleDist.x *= scaleFactorX;
         scaleDist.y *= scaleFactorY;
@@ -350,11 +519,11 @@ void CVViewPanel::fitElements(const bool& fitX,
     }
     else if(fitX || fitY)
     {
-        sf::FloatRect newBounds = viewPanelElements.front()->getBounds();
+        sf::FloatRect newBounds = contentBounds(viewPanelElements.front());
 
         for(size_t i = 1; i < numPanels(); ++i)
         {
-            expandBounds(newBounds, viewPanelElements[i]->getBounds());
+            expandBounds(newBounds, contentBounds(viewPanelElements[i]));
         }
 
         sf::Vector2f newPosition = getPosition();
@@ -390,6 +559,32 @@ CVElement* CVViewPanel::getOwnedElementByID(const string& tag)
 
     if(tag.empty()) return nullptr;
 
+    if(bIndexed)
+    {
+        // Resolve through the view's tag index.  Tags shared within this panel fall
+        // through to the search below, so the first match in member order wins
+
+        CVElement* output = nullptr;
+        bool bShared = false;
+
+        for(auto& element : View->getElementsByTag(tag))
+        {
+            for(CVViewPanel* owner = element->viewPanel; owner; owner = owner->viewPanel)
+            {
+                if(owner == this)
+                {
+                    bShared = output != nullptr;
+                    output = element;
+                    break;
+                }
+            }
+
+            if(bShared) break;
+        }
+
+        if(!bShared) return output;
+    }
+
     for(auto& element : viewPanelElements)
     {
         if(element->tag() == tag)
@@ -429,6 +624,95 @@ void CVViewPanel::setHighlightableStatus(const bool& status)
     }
 }
 
+void CVViewPanel::setSpatialIndex(const bool& state, const float& cellSize)
+{
+    if(state)
+    {
+        const float gridSize = cellSize > 0.0f ? cellSize : 64.0f*View->getViewScale();
+
+        if(hitGrid)
+        {
+            hitGrid->setCellSize(gridSize);
+        }
+        else
+        {
+            hitGrid = new CVSpatialGrid(gridSize);
+            for(auto& item : viewPanelElements)
+            {
+                hitGrid->insert(item);
+            }
+        }
+    }
+    else if(hitGrid)
+    {
+        delete(hitGrid);
+        hitGrid = nullptr;
+        hitElements.clear();
+        hitOrder.clear();
+    }
+}
+
+CVElement* CVViewPanel::elementAt(const sf::Vector2f& position)
+{
+
+    const sf::Vector2f memberPosition = position - contentOffset;
+
+    if(!hitGrid)
+    {
+        for(int i = viewPanelElements.size() - 1; i >= 0; --i)
+        {
+            if(viewPanelElements[i]->getBounds().contains(memberPosition))
+            {
+                return viewPanelElements[i];
+            }
+        }
+        return nullptr;
+    }
+
+    vector<CVElement*> hits;
+    hitGrid->flush();
+    hitGrid->query(memberPosition, hits);
+
+    // Rebuild the draw order lookup only when the member list has changed
+
+    for(auto& item : hits)
+    {
+        auto it = hitOrder.find(item);
+        if((it == hitOrder.end()) ||
+           (it->second >= viewPanelElements.size()) ||
+           (viewPanelElements[it->second] != item))
+        {
+            hitOrder.clear();
+            for(size_t i = 0; i < viewPanelElements.size(); ++i)
+            {
+                hitOrder[viewPanelElements[i]] = i;
+            }
+            break;
+        }
+    }
+
+    CVElement* output = nullptr;
+    size_t topIndex = 0;
+
+    for(auto& item : hits)
+    {
+        auto it = hitOrder.find(item);
+        if((it != hitOrder.end()) && (!output || (it->second > topIndex)))
+        {
+            output = item;
+            topIndex = it->second;
+        }
+    }
+
+    return output;
+
+}
+
+bool CVViewPanel::needsUpdate() const
+{
+    return true;    // Members are filtered by the panel's own updatePanels()
+}
+
 void CVViewPanel::setFocus(const bool& state)
 {
     CVElement::setFocus(state);
@@ -310,7 +310,8 @@ bool CVTitleBar::update(CVEvent& event, const sf::Vector2f& mousePos)
         }
     }
 
-    if(event.LMBhold &&
+    if(View->viewPort &&
+            event.LMBhold &&
             bounds.contains(event.LMBpressPosition) &&
             event.captureMouse())
     {
@@ -686,6 +687,12 @@ void CVProgressBar::setProgress(const float& newProgress)
     else progress = newProgress;
 }
 
+bool CVProgressBar::needsUpdate() const
+{
+    return CVTextBox::needsUpdate() ||
+            ((panel.size() > 1) && (abs(panel[1].getSize().x - progress*bounds.width) > 0.5f)); // Bar still easing toward progress
+}
+
 bool CVProgressBar::update(CVEvent& event, const sf::Vector2f& mousePos)
 {
     if(!CVTextBox::update(event, mousePos)) return false;